@@ -0,0 +1,104 @@
+/*
+ * bench_buffer.c
+ *
+ * Host benchmark of the { ... } buffer decoding (cli_get_buffer_argument). Sends calibration like blobs of 2 digits bytes
+ * ({ 0A 1B 2C ... }) and prints the decoding speed in bytes per micro second. Build it once with the word at a time decoder
+ * and once without to compare (the reception ring must hold the biggest command) :
+ *
+ *     gcc -O2 -Icli/inc -DCLI_RX_RING_SIZE=8192 -DCLI_BUFFER_SWAR_EN=1 cli/bench/bench_buffer.c cli/src/cli_internal.c -o bench_buffer && ./bench_buffer
+ *     gcc -O2 -Icli/inc -DCLI_RX_RING_SIZE=8192 -DCLI_BUFFER_SWAR_EN=0 cli/bench/bench_buffer.c cli/src/cli_internal.c -o bench_buffer && ./bench_buffer
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <time.h>
+
+#include "cli.h"
+
+/**********************************************
+ * DEFINES
+ *********************************************/
+
+#define BENCH_MAX_BYTES     2048
+#define BENCH_ROUNDS        2000
+
+/**********************************************
+ * PRIVATE VARIABLES
+ *********************************************/
+
+static char cliBuff[BENCH_MAX_BYTES * 3 + 16];
+static uint8_t blob[BENCH_MAX_BYTES];
+static size_t blobRead = 0;
+static uint64_t decodeNs = 0;
+
+/**********************************************
+ * PRIVATE FUNCTIONS
+ *********************************************/
+
+static uint64_t bench_now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void blobFn(void){
+    uint64_t const start = bench_now_ns();
+
+    blobRead = cli_get_buffer_argument(0, blob, sizeof(blob), NULL);
+
+    decodeNs += bench_now_ns() - start;
+}
+
+static void bench_send(char const* cmd){
+    for(size_t i = 0; cmd[i] != '\0'; i++) cli_insert_char(cliBuff, sizeof(cliBuff), cmd[i]);
+
+    cli_insert_char(cliBuff, sizeof(cliBuff), '\n');
+    cli_treat_command(cliBuff, sizeof(cliBuff));
+}
+
+/**********************************************
+ * GLOBAL VARIABLES
+ *********************************************/
+
+cliElement_t cliMainMenu[] = {
+    cliActionElement("blob",    blobFn,     "b",    "Receives a buffer"),
+    cliMenuTerminator()
+};
+
+/**********************************************
+ * PUBLIC FUNCTIONS
+ *********************************************/
+
+void cli_printf(char const * const str, ...){
+    (void) str;
+}
+
+int main(void){
+    static char cmd[sizeof(cliBuff)];
+    static size_t const sizes[] = { 16, 256, 1024, 2048 };
+
+    printf("CLI_BUFFER_SWAR_EN = %d\n", CLI_BUFFER_SWAR_EN);
+
+    for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++){
+        size_t len = (size_t) sprintf(cmd, "blob {");
+
+        for(size_t i = 0; i < sizes[s]; i++) len += (size_t) sprintf(&cmd[len], " %02X", (unsigned) ( (i * 37) & 0xFF ));
+
+        sprintf(&cmd[len], " }");
+
+        decodeNs = 0;
+
+        for(int r = 0; r < BENCH_ROUNDS; r++) bench_send(cmd);
+
+        if(blobRead != sizes[s]){
+            printf("Decoding failed, read %u bytes instead of %u\n", (unsigned) blobRead, (unsigned) sizes[s]);
+            return 1;
+        }
+
+        double const us = (double) decodeNs / 1000.0 / BENCH_ROUNDS;
+
+        printf("%5u bytes : %8.3f us per buffer, %7.2f bytes/us\n", (unsigned) sizes[s], us, sizes[s] / us);
+    }
+
+    return 0;
+}
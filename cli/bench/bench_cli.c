@@ -0,0 +1,421 @@
+/*
+ * bench_cli.c
+ *
+ * Host benchmark of the command treatment. Builds a synthetic menu tree ('-w' elements per menu, '-d' levels of sub menus) ending
+ * in one action per argument type ('i', 'u', 's', 'b', '*' and 'i...', each with '-n' arguments), then measures for each type the
+ * time spent in the name lookup, in the arguments verification, in the cli_get_*_argument calls, and the whole treatment from
+ * cli_ctx_insert_chars to the end of the action. cli_internal.c is included by the benchmark so each phase can be timed alone :
+ *
+ *     gcc -O2 -Icli/inc cli/bench/bench_cli.c -o bench_cli
+ *     ./bench_cli -w 32 -d 4 -n 4 -r 20000 -f csv >> results.csv
+ *
+ * Long commands (deep menus, many arguments) must fit in the reception ring, add -DCLI_RX_RING_SIZE=4096 in that case.
+ *
+ * Results are printed as a table (-f text, default), as CSV (-f csv) or as JSON (-f json), in nanoseconds per command. Build it with
+ * the same CLI_* options as the firmware to compare configurations.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <time.h>
+
+//The lookup is timed on the linear search of cliElement_t menus built at run time, the trie, the prebuilt help and the compact tables
+//need tables generated for the synthetic menus
+#undef CLI_TRIE_EN
+#define CLI_TRIE_EN 0
+#undef CLI_HELP_PREBUILT_EN
+#define CLI_HELP_PREBUILT_EN 0
+#undef CLI_COMPACT_EN
+#define CLI_COMPACT_EN 0
+
+#include "../src/cli_internal.c"
+
+/**********************************************
+ * DEFINES
+ *********************************************/
+
+#define BENCH_MAX_WIDTH     250
+#define BENCH_MAX_DEPTH     32
+#define BENCH_MAX_LINE      4096
+#define BENCH_TYPES         6
+
+/**********************************************
+ * PRIVATE TYPES
+ *********************************************/
+
+typedef enum{
+    BENCH_GET_INT,
+    BENCH_GET_UINT,
+    BENCH_GET_STRING,
+    BENCH_GET_BUFFER,
+}benchGet_e;
+
+typedef struct benchCase{
+    char const*         type;                           //Type as written in the results
+    char const*         name;                           //Name of the action in the leaf menu
+    char                spec[CLI_MAX_ARGUMENTS + 4];    //Arguments of the action
+    char                cmd[BENCH_MAX_LINE];            //Whole command, menus path included
+    size_t              len;
+    benchGet_e          gets[CLI_MAX_ARGUMENTS];        //Getter used for each argument
+    double              lookupNs;
+    double              verifyNs;
+    double              getNs;
+    double              totalNs;
+}benchCase_t;
+
+typedef struct benchToken{
+    char const*         str;
+    benchGet_e          get;
+}benchToken_t;
+
+/**********************************************
+ * PRIVATE VARIABLES
+ *********************************************/
+
+static benchToken_t const tokens[] = {
+    { "-1234567",                           BENCH_GET_INT    },
+    { "0xDEADBEEF",                         BENCH_GET_UINT   },
+    { "\"hello world\"",                    BENCH_GET_STRING },
+    { "{ 0A 1B 2C 3D 4E 5F 60 71 }",        BENCH_GET_BUFFER },
+};
+
+static benchCase_t cases[BENCH_TYPES] = {
+    { .type = "i",      .name = "ti" },
+    { .type = "u",      .name = "tu" },
+    { .type = "s",      .name = "ts" },
+    { .type = "b",      .name = "tb" },
+    { .type = "*",      .name = "ta" },
+    { .type = "...",    .name = "te" },
+};
+
+static size_t width = 16;
+static size_t depth = 2;
+static size_t argsN = 4;
+static size_t rounds = 20000;
+static char const* format = "text";
+
+static char names[BENCH_MAX_WIDTH][8];
+
+static cli_ctx_t benchCtx;
+static char benchBuffer[BENCH_MAX_LINE];
+static char line[BENCH_MAX_LINE];
+
+static benchCase_t const* currCase = NULL;
+static size_t executed = 0;
+static size_t failures = 0;
+static double timerNs = 0;
+
+/**********************************************
+ * GLOBAL VARIABLES
+ *********************************************/
+
+//Filled by bench_build_menus, with the width given on the command line
+cliElement_t cliMainMenu[BENCH_MAX_WIDTH + BENCH_TYPES + 1];
+
+/**********************************************
+ * PRIVATE FUNCTIONS
+ *********************************************/
+
+static uint64_t bench_now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void bench_sink(void* arg, char const * const str, va_list args){
+    (void) arg;
+    (void) str;
+    (void) args;
+}
+
+//Elements have const members, they are written once when the tree is built
+static void bench_set(cliElement_t* dst, cliElement_t const src){
+    memcpy(dst, &src, sizeof(cliElement_t));
+}
+
+static void bench_get(void){
+    static uint8_t buff[64];
+
+    for(size_t i = 0; i < argsN; i++){
+        bool res = false;
+
+        switch(currCase->gets[i]){
+            case BENCH_GET_INT    : (void) cli_get_int_argument(i, &res); break;
+            case BENCH_GET_UINT   : (void) cli_get_uint_argument(i, &res); break;
+            case BENCH_GET_STRING : (void) cli_get_string_argument(i, buff, sizeof(buff), &res); break;
+            case BENCH_GET_BUFFER : (void) cli_get_buffer_argument(i, buff, sizeof(buff), &res); break;
+        }
+
+        if(!res) failures++;
+    }
+}
+
+static void benchFn(void){
+    executed++;
+    bench_get();
+}
+
+//Level k of the tree holds 'width' sub menus all referencing level k + 1, the last level holds 'width' actions then the benchmarked ones
+static void bench_build_menus(void){
+    cliElement_t* levels[BENCH_MAX_DEPTH + 1];
+
+    levels[0] = cliMainMenu;
+
+    for(size_t k = 1; k <= depth; k++){
+        levels[k] = malloc( (width + BENCH_TYPES + 1) * sizeof(cliElement_t) );
+
+        if(levels[k] == NULL){
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+
+    for(size_t k = 0; k < depth; k++){
+        for(size_t i = 0; i < width; i++) bench_set(&levels[k][i], (cliElement_t) cliSubMenuElement(names[i], levels[k + 1], "Synthetic menu"));
+
+        bench_set(&levels[k][width], (cliElement_t) cliMenuTerminator());
+    }
+
+    cliElement_t* const leaf = levels[depth];
+
+    for(size_t i = 0; i < width; i++) bench_set(&leaf[i], (cliElement_t) cliActionElement(names[i], benchFn, "", "Synthetic action"));
+
+    for(size_t t = 0; t < BENCH_TYPES; t++) bench_set(&leaf[width + t], (cliElement_t) cliActionElement(cases[t].name, benchFn, cases[t].spec, "Benchmarked action"));
+
+    bench_set(&leaf[width + BENCH_TYPES], (cliElement_t) cliMenuTerminator());
+}
+
+//Commands go through the last element of every menu, so the lookup is the worst case of the linear search
+static void bench_build_cases(void){
+    for(size_t i = 0; i < width; i++) sprintf(names[i], "n%03u", (unsigned) i);
+
+    for(size_t t = 0; t < BENCH_TYPES; t++){
+        benchCase_t* const c = &cases[t];
+        size_t len = 0;
+
+        for(size_t k = 0; k < depth; k++) len += (size_t) sprintf(&c->cmd[len], "%s ", names[width - 1]);
+
+        len += (size_t) sprintf(&c->cmd[len], "%s", c->name);
+
+        for(size_t i = 0; i < argsN; i++){
+            size_t tkn = 0;
+
+            switch(c->type[0]){
+                case 'i' : tkn = 0; break;
+                case 'u' : tkn = 1; break;
+                case 's' : tkn = 2; break;
+                case 'b' : tkn = 3; break;
+                case '*' : tkn = i % (sizeof(tokens) / sizeof(tokens[0])); break;
+                default  : tkn = 0; break;
+            }
+
+            if(c->type[0] != '.') c->spec[i] = c->type[0];
+
+            c->gets[i] = tokens[tkn].get;
+            len += (size_t) sprintf(&c->cmd[len], " %s", tokens[tkn].str);
+        }
+
+        if(c->type[0] == '.') strcpy(c->spec, "i...");
+
+        c->len = len;
+
+        if(len + 2 > sizeof(benchBuffer)){
+            fprintf(stderr, "Command of %u bytes too long, reduce -d or -n\n", (unsigned) len);
+            exit(1);
+        }
+
+        #if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+        if(len + 2 > CLI_RX_SIZE(&benchCtx)){
+            fprintf(stderr, "Command of %u bytes too long, reduce -d or -n or increase CLI_RX_RING_SIZE\n", (unsigned) len);
+            exit(1);
+        }
+        #endif
+    }
+}
+
+//Same walk as cli_find_action, stopping on the action
+static cliElement_t* bench_lookup(cli_ctx_t* ctx){
+    cliElement_t init = cliSubMenuElement("main", cliMainMenu, "main menu");
+    cliElement_t* currentMenu = &init;
+
+    for(char* tkn = cli_next_token(ctx); tkn != NULL; tkn = cli_next_token(ctx)){
+        cliElement_t* e = cli_find_element_in_menu(ctx, tkn, currentMenu);
+
+        if(e == NULL) return NULL;
+        if(cli_is_action(e)) return e;
+
+        currentMenu = e;
+    }
+
+    return NULL;
+}
+
+static void bench_calibrate(void){
+    uint64_t const start = bench_now_ns();
+
+    for(size_t r = 0; r < rounds; r++) (void) bench_now_ns();
+
+    timerNs = (double) (bench_now_ns() - start) / (double) rounds;
+}
+
+//Time of one phase, without the time taken by reading the clock
+static double bench_elapsed(uint64_t start, uint64_t end){
+    double const ns = (double) (end - start) - timerNs;
+
+    return ( (ns < 0) ? 0 : ns );
+}
+
+static void bench_run(benchCase_t* c){
+    cli_ctx_t* const ctx = &benchCtx;
+    double lookup = 0, verify = 0, get = 0;
+
+    currCase = c;
+    failures = 0;
+    executed = 0;
+
+    for(size_t r = 0; r < rounds; r++){
+        memcpy(line, c->cmd, c->len + 1);
+
+        ctx->line = line;
+        ctx->nextTkn = line;
+
+        uint64_t const t0 = bench_now_ns();
+        cliElement_t* const e = bench_lookup(ctx);
+        uint64_t const t1 = bench_now_ns();
+
+        if(e == NULL){
+            fprintf(stderr, "Action '%s' not found\n", c->name);
+            exit(1);
+        }
+
+        ctx->argsStr = ctx->nextTkn;
+
+        uint64_t const t2 = bench_now_ns();
+        bool const valid = cli_verify_arguments(ctx, e);
+        uint64_t const t3 = bench_now_ns();
+
+        if(!valid){
+            fprintf(stderr, "Arguments of '%s' refused : %s\n", c->name, c->cmd);
+            exit(1);
+        }
+
+        ctx->currEl = e;
+        cliCurrCtx = ctx;
+
+        uint64_t const t4 = bench_now_ns();
+        bench_get();
+        uint64_t const t5 = bench_now_ns();
+
+        cliCurrCtx = NULL;
+        ctx->currEl = NULL;
+        ctx->argsStr = NULL;
+
+        lookup += bench_elapsed(t0, t1);
+        verify += bench_elapsed(t2, t3);
+        get += bench_elapsed(t4, t5);
+    }
+
+    //Whole treatment, through the public API
+    memcpy(line, c->cmd, c->len);
+    line[c->len] = '\n';
+
+    uint64_t const start = bench_now_ns();
+
+    for(size_t r = 0; r < rounds; r++){
+        cli_ctx_insert_chars(ctx, line, c->len + 1);
+
+        #if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+        cli_ctx_treat_command(ctx);
+        #endif
+    }
+
+    c->totalNs = (double) (bench_now_ns() - start) / (double) rounds;
+
+    if(failures != 0 || executed != rounds){
+        fprintf(stderr, "'%s' failed : %u executions out of %u, %u arguments not read\n", c->name, (unsigned) executed, (unsigned) rounds, (unsigned) failures);
+        exit(1);
+    }
+
+    c->lookupNs = lookup / (double) rounds;
+    c->verifyNs = verify / (double) rounds;
+    c->getNs = get / (double) rounds;
+}
+
+static void bench_print(void){
+    if(strcmp(format, "csv") == 0){
+        printf("type,width,depth,args,rounds,lookup_ns,verify_ns,get_ns,total_ns\n");
+
+        for(size_t t = 0; t < BENCH_TYPES; t++){
+            benchCase_t const * const c = &cases[t];
+            printf("%s,%u,%u,%u,%u,%.1f,%.1f,%.1f,%.1f\n", c->type, (unsigned) width, (unsigned) depth, (unsigned) argsN, (unsigned) rounds,
+                   c->lookupNs, c->verifyNs, c->getNs, c->totalNs);
+        }
+
+        return;
+    }
+
+    if(strcmp(format, "json") == 0){
+        printf("[\n");
+
+        for(size_t t = 0; t < BENCH_TYPES; t++){
+            benchCase_t const * const c = &cases[t];
+            printf("  { \"type\": \"%s\", \"width\": %u, \"depth\": %u, \"args\": %u, \"rounds\": %u, "
+                   "\"lookup_ns\": %.1f, \"verify_ns\": %.1f, \"get_ns\": %.1f, \"total_ns\": %.1f }%s\n",
+                   c->type, (unsigned) width, (unsigned) depth, (unsigned) argsN, (unsigned) rounds,
+                   c->lookupNs, c->verifyNs, c->getNs, c->totalNs, ( (t + 1 < BENCH_TYPES) ? "," : "" ));
+        }
+
+        printf("]\n");
+        return;
+    }
+
+    printf("width %u, depth %u, %u arguments, %u rounds (ns per command)\n", (unsigned) width, (unsigned) depth, (unsigned) argsN, (unsigned) rounds);
+    printf("%-5s %10s %10s %10s %10s\n", "type", "lookup", "verify", "get", "total");
+
+    for(size_t t = 0; t < BENCH_TYPES; t++){
+        benchCase_t const * const c = &cases[t];
+        printf("%-5s %10.1f %10.1f %10.1f %10.1f\n", c->type, c->lookupNs, c->verifyNs, c->getNs, c->totalNs);
+    }
+}
+
+static void bench_usage(char const* name){
+    fprintf(stderr, "usage : %s [-w width (1-%u)] [-d depth (0-%u)] [-n arguments (1-%u)] [-r rounds] [-f text|csv|json]\n",
+            name, BENCH_MAX_WIDTH, BENCH_MAX_DEPTH, CLI_MAX_ARGUMENTS);
+    exit(1);
+}
+
+/**********************************************
+ * PUBLIC FUNCTIONS
+ *********************************************/
+
+int main(int argc, char* argv[]){
+    for(int i = 1; i < argc; i++){
+        if(i + 1 >= argc) bench_usage(argv[0]);
+
+        char const * const val = argv[++i];
+
+        if(strcmp(argv[i - 1], "-w") == 0)      width = strtoul(val, NULL, 0);
+        else if(strcmp(argv[i - 1], "-d") == 0) depth = strtoul(val, NULL, 0);
+        else if(strcmp(argv[i - 1], "-n") == 0) argsN = strtoul(val, NULL, 0);
+        else if(strcmp(argv[i - 1], "-r") == 0) rounds = strtoul(val, NULL, 0);
+        else if(strcmp(argv[i - 1], "-f") == 0) format = val;
+        else bench_usage(argv[0]);
+    }
+
+    if(width == 0 || width > BENCH_MAX_WIDTH || depth > BENCH_MAX_DEPTH || argsN == 0 || argsN > CLI_MAX_ARGUMENTS || rounds == 0){
+        bench_usage(argv[0]);
+    }
+
+    cli_ctx_init(&benchCtx, benchBuffer, sizeof(benchBuffer));
+    cli_ctx_set_output(&benchCtx, bench_sink, NULL);
+
+    bench_build_cases();
+    bench_build_menus();
+    bench_calibrate();
+
+    for(size_t t = 0; t < BENCH_TYPES; t++) bench_run(&cases[t]);
+
+    bench_print();
+
+    return 0;
+}
@@ -1,6 +1,6 @@
 #include "cli.h"
 
-#if (defined(CLI_EN) && CLI_EN == 1)
+#if (defined(CLI_EN) && CLI_EN == 1) && !(defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1)
 
 /**********************************************
  * EXTERNAL VARIABLES
@@ -34,6 +34,19 @@ static void addFn(){
     printf("CLI sum -> %d + %d = %d\n", n1, n2, n1+n2);
 }
 
+#if (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+
+#define SUM_ARGS(ARG, BUF)  ARG(i32, a) ARG(i32, b) BUF(s, label, 16)
+
+CLI_TYPED_ARGS(sumArgs_t, SUM_ARGS)
+
+//typed_sum 10 11 "total"
+//typed_sum -5 0x10 "x"
+static void sumFn(sumArgs_t const* args){
+    printf("CLI %s -> %ld + %ld = %ld\n", args->label, (long) args->a, (long) args->b, (long) args->a + args->b);
+}
+#endif
+
 //hello "hello"
 //hello "hello\nmy name is\n\"gabriel\""\0"
 //he {68 65 6c 6c 6f}
@@ -94,6 +107,10 @@ cliElement_t cliMainMenu[] = {
     cliActionElement(               "fill_be",                             fill_BE,         "b",        "Fills a buffer with bytes sent by CLI (big endian)"                ),
 
     cliActionElementDetailed(       "add",                                 addFn,           "ii",       "adds 2 numbers and prints the result",                     det     ),
+    #if (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+    cliTypedActionElement(          "typed_sum",                           sumFn,           sumArgs_t,  SUM_ARGS,   "adds 2 numbers and prints the result with a label"         ),
+    #endif
+    
     cliActionElement(               "hello",                               helloFn,         "s",        "Prints a string passed by argument"                                ),
     
     #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
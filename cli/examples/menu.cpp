@@ -0,0 +1,98 @@
+#include "cli.hpp"
+
+#if (defined(CLI_EN) && CLI_EN == 1) && !(defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1)
+
+//Same menu as menu.c declared with cli.hpp, build one or the other
+
+/**********************************************
+ * EXTERNAL VARIABLES
+ *********************************************/
+ 
+extern "C" cliElement_t subMenu[];
+
+/**********************************************
+ * PRIVATE VARIABLES
+ *********************************************/
+
+static cliArgumentsDetails_t det[] = {
+    "First number to add",
+    "Second number to add",
+    NULL
+};
+
+/**********************************************
+ * PRIVATE FUNCTIONS
+ *********************************************/
+
+//add 10 11
+//a 10 -10
+static void addFn(int8_t n1, int8_t n2){
+    printf("CLI sum -> %d + %d = %d\n", n1, n2, n1+n2);
+}
+
+//hello "hello"
+//he {68 65 6c 6c 6f}
+static void helloFn(cli::String<100> const& str){
+    printf("CLI hello -> read %lu bytes, string = '%s'\n", (unsigned long) str.len, str.data);
+}
+
+#if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
+
+//d 2.7 3.9
+static void floatDiv(float f1, float f2){
+    printf("Cli div -> %.3f / %.3f = %.3f", f1, f2, f1/f2);
+}
+#endif
+
+//fill_l {  1   2  3  4 }
+static void fill_LE(cli::Buffer<100> const& buffer){
+    printf("read %lu bytes\r\n", (unsigned long) buffer.len);
+    
+    for(size_t i = 0; i < buffer.len; i++) printf("   [%u] = %u -> 0x%02X\n", (unsigned) i, buffer.data[i], buffer.data[i]);
+}
+
+//fill_b {  1   2  3  4 }
+static void fill_BE(){
+    uint8_t buffer[100];
+    
+    size_t bRead = cli_get_buffer_argument_big_endian(0, buffer, sizeof(buffer), NULL);
+    
+    printf("read %lu bytes\r\n", (unsigned long) bRead);
+    
+    for(size_t i = 0; i < bRead; i++) printf("   [%u] = %u -> 0x%02X\n", (unsigned) i, buffer[i], buffer[i]);
+}
+
+/**********************************************
+ * GLOBAL VARIABLES
+ *********************************************/
+
+//A sub menu without reference (the 'robust?' element of menu.c) does not compile here
+//A directive inside the arguments of a macro is undefined behavior, the whole menu is declared in each configuration
+#if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
+CLI_MAIN_MENU(
+    //SUB menus
+    cli::sub(                       "sub",      subMenu,                    "sub menu"                                                          ),
+
+    //ACTION
+    cli::typed<fill_LE>(            "fill_le",                              "Fills a buffer with bytes sent by CLI (little endian)"             ),
+    cli::action(                    "fill_be",  fill_BE,        "b",        "Fills a buffer with bytes sent by CLI (big endian)"                ),
+
+    cli::typed<addFn>(              "add",                                  "adds 2 numbers and prints the result",                     det     ),
+    cli::typed<helloFn>(            "hello",                                "Prints a string passed by argument"                                ),
+    cli::typed<floatDiv>(           "div",                                  "Divides 2 floating numbers"                                        )
+);
+#else
+CLI_MAIN_MENU(
+    //SUB menus
+    cli::sub(                       "sub",      subMenu,                    "sub menu"                                                          ),
+
+    //ACTION
+    cli::typed<fill_LE>(            "fill_le",                              "Fills a buffer with bytes sent by CLI (little endian)"             ),
+    cli::action(                    "fill_be",  fill_BE,        "b",        "Fills a buffer with bytes sent by CLI (big endian)"                ),
+
+    cli::typed<addFn>(              "add",                                  "adds 2 numbers and prints the result",                     det     ),
+    cli::typed<helloFn>(            "hello",                                "Prints a string passed by argument"                                )
+);
+#endif
+
+#endif
@@ -0,0 +1,79 @@
+#include "cli.h"
+
+#if (defined(CLI_EN) && CLI_EN == 1) && (defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1)
+
+//Same menus as menu.c and submenu.c in the compact tables (CLI_COMPACT_EN), build this file instead of them
+
+/**********************************************
+ * PRIVATE FUNCTIONS
+ *********************************************/
+
+//add 10 11
+//a 10 -10
+static void addFn(){
+    int8_t n1 = cli_get_int8_argument(0, NULL);
+    int8_t n2 = cli_get_int8_argument(1, NULL);
+
+    printf("CLI sum -> %d + %d = %d\n", n1, n2, n1+n2);
+}
+
+//hello "hello"
+//he {68 65 6c 6c 6f}
+static void helloFn(){
+    char buffer[100];
+    
+    size_t bRead = cli_get_string_argument(0, (uint8_t*) buffer, sizeof(buffer), NULL);
+    
+    printf("CLI hello -> read %lu bytes, string = '%s'\n", (unsigned long) bRead, buffer);
+}
+
+//fill_l {  1   2  3  4 }
+static void fill_LE(){
+    uint8_t buffer[100];
+    
+    size_t bRead = cli_get_buffer_argument(0, buffer, sizeof(buffer), NULL);
+    
+    printf("read %lu bytes\r\n", (unsigned long) bRead);
+    
+    for(size_t i = 0; i < bRead; i++) printf("   [%u] = %u -> 0x%02X\n", (unsigned) i, buffer[i], buffer[i]);
+}
+
+//s a 1 2 3
+static void average(){
+    float sum = 0;
+    bool res = false;
+    int i = 0;
+    
+    while(1){
+        uint8_t n = cli_get_uint8_argument(i++, &res);
+        
+        if(res == false) break;
+        
+        sum += n;
+    }
+    
+    sum /= (i-1);
+    
+    printf("CLI sub menu -> average -> Average is %.3f\n", sum);
+}
+
+/**********************************************
+ * MENUS
+ *********************************************/
+
+#define CLI_COMPACT_MENUS(MENU)                                                                                                         \
+    MENU(main)                                                                                                                          \
+    MENU(subMenu)
+
+#define CLI_COMPACT_MENU_main(SUB, ACTION)                                                                                              \
+    SUB(            subMenu,        "sub",                  "sub menu"                                                          )       \
+    ACTION(         fill_LE,        "fill_le",      "b",    "Fills a buffer with bytes sent by CLI (little endian)"             )       \
+    ACTION(         addFn,          "add",          "ii",   "adds 2 numbers and prints the result"                              )       \
+    ACTION(         helloFn,        "hello",        "s",    "Prints a string passed by argument"                                )
+
+#define CLI_COMPACT_MENU_subMenu(SUB, ACTION)                                                                                           \
+    ACTION(         average,        "average",      "uu...", "This function calculates the average of various int numbers (2 arg minimum)")
+
+#include "cli_compact.h"
+
+#endif
@@ -0,0 +1,36 @@
+#include "cli.h"
+
+#if (defined(CLI_EN) && CLI_EN == 1) && (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1)
+
+//Module adding its commands to the main menu itself (CLI_REGISTRY_EN), nothing to add in cliMainMenu
+
+/**********************************************
+ * PRIVATE FUNCTIONS
+ *********************************************/
+
+//led_on 3
+//led_on 0x1
+static void ledOn(){
+    printf("CLI led -> led %u on\n", cli_get_uint8_argument(0, NULL));
+}
+
+//led_off 3
+static void ledOff(){
+    printf("CLI led -> led %u off\n", cli_get_uint8_argument(0, NULL));
+}
+
+//version
+//v
+static void version(){
+    printf("CLI version -> 1.0.0\n");
+}
+
+/**********************************************
+ * REGISTERED ELEMENTS
+ *********************************************/
+
+cliRegisterAction(          "led_on",       ledOn,      "u8",       "Turns a led on"                    );
+cliRegisterAction(          "led_off",      ledOff,     "u8",       "Turns a led off"                   );
+cliRegisterAction(          "version",      version,    "",         "Prints the version of the firmware");
+
+#endif
@@ -8,9 +8,14 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <stddef.h>
 
 #include "cli_conf.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**********************************************
  * GENERAL INFO
  *********************************************/
@@ -24,12 +29,20 @@
   *     *    : any argument
   *     ...  : various arguments (must be at the end of the list)
   * 
+  * 'i' and 'u' accept an optional width in bits : i8, i16, i32, i64, u8, u16, u32, u64 (e.g. "u8u8i16"). Without width, 64 is used.
+  * The range is checked during verification, and widths up to 32 bits are parsed with 32 bits arithmetic, so callbacks can narrow
+  * the result with cli_get_uint8_argument & co without checking it again.
+  * 
   * You can pass a parameter as :
   *     i    : -10, 10, 0x10, A, 0xA, a, 0xa (if a-f is in the string, the number is considered HEX. Otherwise the 0x at the beginning is mandatory to HEX valus like 0x10)
   *     u    : 10, 0x10, A, 0xA, a, 0xa (if a-f is in the string, the number is considered HEX. Otherwise the 0x at the beginning is mandatory to HEX valus like 0x10)
   *     b    : {  b1    b2    b3  } (spaces dont matter). b1 b2 and b3 are bytes that can be passed like 'u' arguments (obviously limited to 255 or 0xFF)
   *          : "abc". in this case the data is interpreted as ASCII and copied to the buffer. The \0, \n, \r, \", \\ characters are supported)
+  *          : #0A0B0C. contiguous hex digits, 2 per byte (no spaces, no 0x)
+  *          : $CgsM. base64 (standard alphabet, the '=' padding is optional)
   *     s    : same as 'b' but the buffer is terminated with \0 after getting all bytes
+  * 
+  * Integers that do not fit in int64 ('i') or uint64 ('u') are refused instead of being saturated.
   ***/
 
 /**********************************************
@@ -46,10 +59,123 @@
 #define cli_get_int32_argument(argNum, res)       ((int32_t) cli_get_int_argument(argNum, res))
 #define cli_get_int64_argument(argNum, res)       ((int64_t) cli_get_int_argument(argNum, res))
 
-#define cliMenuTerminator()                                             { NULL,     NULL,            NULL,        NULL,       NULL,       NULL }
-#define cliSubMenuElement(name, ref, desc)                              { (name),   (ref),           NULL,        NULL,       (desc),     NULL }
-#define cliActionElement(name, fn, args, desc)                          { (name),   NULL,            (fn),        (args),     (desc),     NULL }
-#define cliActionElementDetailed(name, fn, args, desc, details)         { (name),   NULL,            (fn),        (args),     (desc),     (details) }
+//Last field of the elements that are not typed actions, so every field is initialized whatever CLI_TYPED_EN
+#if (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+    #define CLI_TYPED_INIT                                              , NULL
+#else
+    #define CLI_TYPED_INIT
+#endif
+
+#define cliMenuTerminator()                                             { NULL,     NULL,            NULL,        NULL,       NULL,       NULL        CLI_TYPED_INIT }
+#define cliSubMenuElement(name, ref, desc)                              { (name),   (ref),           NULL,        NULL,       (desc),     NULL        CLI_TYPED_INIT }
+#define cliActionElement(name, fn, args, desc)                          { (name),   NULL,            (fn),        (args),     (desc),     NULL        CLI_TYPED_INIT }
+#define cliActionElementDetailed(name, fn, args, desc, details)         { (name),   NULL,            (fn),        (args),     (desc),     (details)   CLI_TYPED_INIT }
+
+#if (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+
+/**
+ * Typed actions : the arguments are listed once, in a macro taking ARG(type, name) for numbers and BUF(type, name, size) for buffers
+ *     ARG types : i8, i16, i32, i64, u8, u16, u32, u64, f (float, with CLI_FLOAT_EN)
+ *     BUF types : b (uint8_t name[size], bytes read in nameLen), s (char name[size] terminated by \0, bytes read in nameLen)
+ * 
+ *     #define SUM_ARGS(ARG, BUF)  ARG(i32, a) ARG(i32, b)
+ *     CLI_TYPED_ARGS(sumArgs_t, SUM_ARGS)
+ * 
+ *     static void sumFn(sumArgs_t const* args){ ... args->a + args->b ... }
+ * 
+ *     cliTypedActionElement("sum", sumFn, sumArgs_t, SUM_ARGS, "adds 2 numbers")
+ * 
+ * CLI_TYPED_ARGS declares the structure and the function decoding the verified arguments into it, the arguments string of the element
+ * is generated from the same list ("i32i32"). The callback must take a pointer to the structure, anything else is warned by the compiler
+ ***/
+
+#define CLI_TYPED_CTYPE_i8      int8_t
+#define CLI_TYPED_CTYPE_i16     int16_t
+#define CLI_TYPED_CTYPE_i32     int32_t
+#define CLI_TYPED_CTYPE_i64     int64_t
+#define CLI_TYPED_CTYPE_u8      uint8_t
+#define CLI_TYPED_CTYPE_u16     uint16_t
+#define CLI_TYPED_CTYPE_u32     uint32_t
+#define CLI_TYPED_CTYPE_u64     uint64_t
+#define CLI_TYPED_CTYPE_f       float
+#define CLI_TYPED_CTYPE_b       uint8_t
+#define CLI_TYPED_CTYPE_s       char
+
+//Member of the value decoded during verification (cliArgIndex_t)
+#define CLI_TYPED_VAL_i8        i
+#define CLI_TYPED_VAL_i16       i
+#define CLI_TYPED_VAL_i32       i
+#define CLI_TYPED_VAL_i64       i
+#define CLI_TYPED_VAL_u8        u
+#define CLI_TYPED_VAL_u16       u
+#define CLI_TYPED_VAL_u32       u
+#define CLI_TYPED_VAL_u64       u
+#define CLI_TYPED_VAL_f         f
+
+#define CLI_TYPED_GET_b         cli_get_buffer_argument
+#define CLI_TYPED_GET_s         cli_get_string_argument
+
+#define CLI_TYPED_FIELD(type, name)                 CLI_TYPED_CTYPE_##type name;
+#define CLI_TYPED_FIELD_BUF(type, name, size)       CLI_TYPED_CTYPE_##type name[size]; size_t name##Len;
+#define CLI_TYPED_SPEC(type, name)                  #type
+#define CLI_TYPED_SPEC_BUF(type, name, size)        #type
+
+//Numbers were range checked during verification, they are only copied
+#define CLI_TYPED_DECODE(type, name)                args.name = (CLI_TYPED_CTYPE_##type) ctx->args[i++].val.CLI_TYPED_VAL_##type;
+#define CLI_TYPED_DECODE_BUF(type, name, size)      { bool r = false; args.name##Len = CLI_TYPED_GET_##type(i++, (uint8_t*) args.name, (size), &r); ok = (ok && r); }
+
+#define CLI_TYPED_ARGS(T, LIST)                                                                                                         \
+    typedef struct{ LIST(CLI_TYPED_FIELD, CLI_TYPED_FIELD_BUF) }T;                                                                      \
+                                                                                                                                        \
+    static bool T##_trampoline(struct cli_ctx const * const ctx, void (* const fn)(void)){                                              \
+        T args;                                                                                                                         \
+        size_t i = 0;                                                                                                                   \
+        bool ok = true;                                                                                                                 \
+                                                                                                                                        \
+        LIST(CLI_TYPED_DECODE, CLI_TYPED_DECODE_BUF)                                                                                    \
+                                                                                                                                        \
+        if(ok) ( (void (*)(T const*)) fn )(&args);                                                                                      \
+                                                                                                                                        \
+        return ok;                                                                                                                      \
+    }
+
+#define cliTypedActionElement(name, fn, T, LIST, desc)                                                                                  \
+    { (name), NULL, cli_typed_action, ("" LIST(CLI_TYPED_SPEC, CLI_TYPED_SPEC_BUF)), (desc), NULL,                                     \
+      &(cliTyped_t const){ T##_trampoline, (void (*)(void)) (1 ? (fn) : (void (*)(T const*)) NULL) } }
+
+#endif
+
+#if (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1)
+
+/**
+ * Registered elements : added to the main menu from any source file, without being listed in cliMainMenu
+ * 
+ *     cliRegisterAction("led_on", ledOn, "u8", "turns a led on");
+ *     cliRegisterSubMenu("radio", radioMenu, "radio commands");
+ * 
+ * Each function / sub menu can be registered once (its name makes the name of the registered element). With a custom linker script, the
+ * section must be kept and delimited, e.g. in the flash region :
+ * 
+ *     .cli_registry : { __start_cli_registry = .; KEEP(*(cli_registry)) __stop_cli_registry = .; } > FLASH
+ ***/
+
+//Pointer alignment keeps the elements contiguous in the section, the compiler could align bigger objects further otherwise
+#define CLI_REGISTER(id, element)                                                                                                       \
+    __attribute__((used, section("cli_registry"), aligned(sizeof(void*)))) cliElement_t const cliRegistered_##id = element
+
+#define cliRegisterSubMenu(name, ref, desc)                             CLI_REGISTER(ref, cliSubMenuElement(name, ref, desc))
+#define cliRegisterAction(name, fn, args, desc)                         CLI_REGISTER(fn, cliActionElement(name, fn, args, desc))
+#define cliRegisterActionDetailed(name, fn, args, desc, details)        CLI_REGISTER(fn, cliActionElementDetailed(name, fn, args, desc, details))
+
+#endif
+
+#if (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+#define cliTraceElement()                                               cliActionElement("cli_trace", cli_print_trace, "", "Dumps the trace of the last actions")
+#endif
+
+#if (defined(CLI_STATS_EN) && CLI_STATS_EN == 1)
+#define cliStatsElement()                                               cliActionElement("cli_stats", cli_print_stats, "", "Prints and resets the statistics of the actions")
+#endif
 
 /**********************************************
  * PUBLIC TYPES
@@ -64,6 +190,7 @@ typedef enum{
     CLI_WAITING_TREATMENT,
     CLI_DISABLED,
     CLI_ERR,
+    CLI_RX_FULL,            //Reception ring full, the line being received is dropped
 }cli_status_e;
 
 //CLI functions are always void foo(void)
@@ -72,6 +199,30 @@ typedef void(* const cliAction_t)(void);
 //CLI argument details
 typedef char const * const cliArgumentsDetails_t;
 
+#if (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+struct cli_ctx;
+
+//Callback of a typed action and the function generated by CLI_TYPED_ARGS that decodes its arguments and calls it
+typedef struct cliTyped{
+    bool                                        (* const trampoline)(struct cli_ctx const * const ctx, void (* const fn)(void));
+    void                                        (* const fn)(void);
+}cliTyped_t;
+#endif
+
+#if (defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1)
+//No string, sub menu or action behind a field of a compact element
+#define CLI_COMPACT_NONE        0xFFFF
+
+//CLI element (sub menu or action) of the const tables generated by cli_compact.h. Strings are offsets in cliCompactStrings, the element
+//at index 0 of cliCompactElements is the main menu
+typedef struct cliElement{
+    uint16_t const                              name;       //Unique name
+    uint16_t const                              desc;       //Description of the element
+    uint16_t const                              args;       //Arguments (if action), CLI_COMPACT_NONE if sub menu
+    uint16_t const                              ref;        //Index of the first element of the sub menu in cliCompactElements, or of the
+                                                            //action in cliCompactActions
+}cliElement_t;
+#else
 //CLI element (sub menu or action)
 typedef struct cliElement{
     char const * const                          name;       //Unique name
@@ -85,22 +236,314 @@ typedef struct cliElement{
 
     cliArgumentsDetails_t const * const         argsDesc;   //Array of strings to describe each argument (NULL to ignore)
 
+    #if (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+    cliTyped_t const * const                    typed;      //Typed callback (cliTypedActionElement), NULL for the other elements
+    #endif
+
     
 }cliElement_t;
+#endif
+
+//Marks the absence of a node / menu in the generated trie, and the 'element' of a node whose prefix is shared by several elements
+#define CLI_TRIE_NONE           0xFFFF
+#define CLI_TRIE_AMBIGUOUS      0xFFFF
+
+//Prefix trie node generated by cli/tools/cli_trie_gen.c. A node only exists while its prefix is shared by more than one element,
+//once a prefix becomes unique the node is a leaf and the remaining characters are compared against the element name
+typedef struct cliTrieNode{
+    uint16_t                                    next;       //First child (CLI_TRIE_AMBIGUOUS node) or sub menu index of the element (leaf)
+    uint16_t                                    sibling;    //Next node with the same parent (CLI_TRIE_NONE if last)
+    uint16_t                                    element;    //Index of the element inside its menu, CLI_TRIE_AMBIGUOUS if not unique yet
+    char                                        c;          //Lower case character leading to this node
+}cliTrieNode_t;
+
+//No sub menu behind a prebuilt help element
+#define CLI_HELP_NONE           0xFFFF
+
+//Help of one element generated by cli/tools/cli_help_gen.c
+typedef struct cliHelpElement{
+    uint16_t                                    subMenu;    //Index of the sub menu of the element (depth first order), CLI_HELP_NONE if action
+    uint16_t                                    usageLen;   //Length of usage, without the terminator
+    char const*                                 usage;      //Usage printed when the arguments of an action are invalid, NULL if not prebuilt
+}cliHelpElement_t;
+
+//Kinds an argument was recognized as during verification (bit field, a '*' argument can be more than one)
+#define CLI_ARG_KIND_INT        (1 << 0)
+#define CLI_ARG_KIND_UINT       (1 << 1)
+#define CLI_ARG_KIND_FLOAT      (1 << 2)
+#define CLI_ARG_KIND_BUFFER     (1 << 3)
+
+//Position and value of an argument inside the arguments string, filled once during verification
+typedef struct{
+    uint16_t start;     //Offset from the beginning of the arguments
+    uint16_t len;       //Length of the argument (quotes and braces included)
+    uint8_t  kind;      //CLI_ARG_KIND_* bits
+    
+    union{              //Value decoded during verification (integer if the argument is an integer, float otherwise)
+        int64_t  i;
+        uint64_t u;
+        #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
+        float    f;
+        #endif
+    }val;
+}cliArgIndex_t;
+
+//Arguments string of an action, parsed once and kept while the same element is in use
+typedef struct{
+    uint8_t count;                          //Amount of typed arguments (ellipsis excluded)
+    bool    elipsis;                        //True if the list ends with '...'
+    char    types[CLI_MAX_ARGUMENTS];       //Type character of each argument
+    uint8_t widths[CLI_MAX_ARGUMENTS];      //Width in bits of 'i' and 'u' arguments (8, 16, 32 or 64)
+}cliArgsSpec_t;
+
+//Occupancy of the reception queue of an instance (polling mode)
+typedef struct{
+    size_t commands;        //Complete commands waiting for cli_treat_command
+    size_t depth;           //Maximum amount of waiting commands (CLI_RX_QUEUE_DEPTH)
+    size_t bytes;           //Bytes of the reception ring used by the waiting commands
+    size_t size;            //Size of the reception ring (CLI_RX_RING_SIZE)
+}cliRxStatus_t;
+
+//Output of a CLI instance, same contract as vprintf. 'arg' is the pointer given to cli_ctx_set_output
+typedef void (*cliPrint_t)(void* arg, char const * str, va_list args);
+
+//Start of a transfer of the TX ring (DMA kick...). 'data' stays valid until cli_ctx_tx_done is called, which can be done from the
+//end of transfer interrupt, or before returning for blocking outputs. 'arg' is the pointer given to cli_ctx_set_flush
+typedef void (*cliFlush_t)(void* arg, char const data[], size_t len);
+
+//CLI instance. Every field is private, use cli_ctx_init and the cli_ctx_* functions. One instance can be created per console
+//(debug UART, RTT, USB CDC...), each one with its own buffer, parse state and output
+typedef struct cli_ctx{
+    char*                                       buffer;     //Command buffer
+    size_t                                      size;       //Size of the command buffer
+    size_t                                      len;        //Amount of characters received
+
+    #if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+    //Single producer (cli_ctx_insert_char, ISR) / single consumer (cli_ctx_treat_command) ring of received lines, each one
+    //terminated by '\0'. Each index is written by only one side, so no lock nor shared flag is needed (in zero copy mode the producer
+    //also rewinds rxHead and rxTail while no line is waiting, the consumer does not read them then)
+    #if !(defined(CLI_ZERO_COPY_EN) && CLI_ZERO_COPY_EN == 1)
+    char                                        rxRing[CLI_RX_RING_SIZE];
+    #endif
+    volatile size_t                             rxHead;     //End of the last complete line, written by the producer
+    volatile size_t                             rxTail;     //Start of the oldest line, written by the consumer
+    volatile size_t                             rxLinesIn;  //Lines published, written by the producer
+    volatile size_t                             rxLinesOut; //Lines taken out, written by the consumer
+    size_t                                      rxLine;     //Start of the line being received
+    size_t                                      rxWrite;    //Producer position inside the line being received
+    cli_status_e                                rxDrop;     //Reason the line being received is dropped, CLI_NONE if kept
+    #endif
+
+    char*                                       line;       //Command being treated (inside the ring in zero copy mode)
+    char*                                       nextTkn;    //Tokenizer position inside the command
+    char*                                       argsStr;    //Arguments of the action being treated
+    cliElement_t*                               currEl;     //Action being executed
+    cliArgIndex_t                               args[CLI_MAX_ARGUMENTS];
+    size_t                                      argsCount;
+    cliElement_t const*                         specEl;     //Element described by spec
+    cliArgsSpec_t                               spec;
+
+    #if (defined(CLI_INCREMENTAL_EN) && CLI_INCREMENTAL_EN == 1) && !(defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+    //State of the parse done while the characters are received
+    cliElement_t*                               incMenu;    //Menu the next name is looked up in, NULL for the main menu
+    cliElement_t*                               incAction;  //Action found, its arguments are being verified
+    size_t                                      incTkn;     //Start of the name / argument being received
+    size_t                                      incArgs;    //Arguments verified
+    uint16_t                                    incMenuIdx; //Trie index of incMenu
+    uint8_t                                     incState;   //CLI_INC_* (cli_internal.c)
+    bool                                        incMuted;   //Prints disabled, errors are printed by the treatment at the end of the line
+    #endif
+
+    #if (defined(CLI_STATS_EN) && CLI_STATS_EN == 1) || (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+    uint32_t                                    treatStart; //CLI_STATS_TIMER when the treatment of the command started
+    #endif
+
+    cliPrint_t                                  print;      //Output, NULL to use cli_printf
+    void*                                       printArg;
+
+    #if (defined(CLI_TX_BUFFER_SIZE) && CLI_TX_BUFFER_SIZE > 0)
+    char                                        txRing[CLI_TX_BUFFER_SIZE];
+    volatile size_t                             txHead;     //Written by the CLI, once the characters are in txRing
+    volatile size_t                             txTail;     //Released by cli_ctx_tx_done
+    volatile size_t                             txBusy;     //Length of the transfer in progress, 0 if none
+    size_t                                      txDropped;  //Characters dropped because the ring was full
+    cliFlush_t                                  flush;      //Buffered output, used instead of print if not NULL
+    void*                                       flushArg;
+    #endif
+}cli_ctx_t;
 
 /**********************************************
  * PUBLIC FUNCTIONS
  *********************************************/
  
+/*************************************************
+ * CLI Context Init
+ * 
+ * @brief Prepares a CLI instance working on the given buffer. Instances are independent, each console can have its own one, 
+ * fed and treated from its own task. The functions without context (cli_insert_char...) use an internal default instance
+ * 
+ * @param cli_ctx_t* ctx : Instance to initialize [out]
+ * @param char buffer[]  : Buffer that will contain the commands of this instance [in]
+ * @param size_t size    : Size of the buffer (sizeof(buffer) normally), a power of 2 with CLI_ZERO_COPY_EN [in]
+ * 
+ ************************************************/
+void cli_ctx_init(cli_ctx_t* ctx, char buffer[], size_t size);
+
+/*************************************************
+ * CLI Context Set Output
+ * 
+ * @brief Sets where the menus, errors and cli_ctx_printf of this instance are printed. Without output, cli_printf is used
+ * 
+ * @param cli_ctx_t* ctx   : Instance [in]
+ * @param cliPrint_t print : vprintf like function, NULL to go back to cli_printf [in]
+ * @param void* arg        : Pointer given back to print (UART handle, RTT channel...) [in]
+ * 
+ ************************************************/
+void cli_ctx_set_output(cli_ctx_t* ctx, cliPrint_t print, void* arg);
+
+/*************************************************
+ * CLI Context Printf
+ * 
+ * @brief Prints on the output of an instance. Inside an action, use cli_ctx_printf(cli_get_current_ctx(), ...) to answer on the 
+ * console the command came from
+ * 
+ * @param cli_ctx_t* ctx : Instance [in]
+ * @param char* str      : String containing information to be printed [in]
+ * @param ...            : Various arguments to print [in]
+ * 
+ ************************************************/
+void cli_ctx_printf(cli_ctx_t* ctx, char const * const str, ...);
+
+#if (defined(CLI_TX_BUFFER_SIZE) && CLI_TX_BUFFER_SIZE > 0)
+
+/*************************************************
+ * CLI Context Set Flush
+ * 
+ * @brief Sends the output of this instance through its TX ring. Prints are copied in the ring, and flush is called with big contiguous
+ * blocks at the end of each command, when the ring is full, or on cli_ctx_flush. Only one transfer is in progress at a time. The CLI
+ * never waits for it : what does not fit in the ring is dropped and counted in ctx->txDropped
+ * 
+ * @param cli_ctx_t* ctx   : Instance [in]
+ * @param cliFlush_t flush : Function starting a transfer, NULL to go back to the print output [in]
+ * @param void* arg        : Pointer given back to flush [in]
+ * 
+ ************************************************/
+void cli_ctx_set_flush(cli_ctx_t* ctx, cliFlush_t flush, void* arg);
+
+/*************************************************
+ * CLI Context Tx Done
+ * 
+ * @brief Signals the end of the transfer started by flush. Releases its place in the ring and starts the next transfer if needed. Can
+ * be called from the end of transfer interrupt
+ * 
+ * @param cli_ctx_t* ctx : Instance [in]
+ * 
+ ************************************************/
+void cli_ctx_tx_done(cli_ctx_t* ctx);
+
+/*************************************************
+ * CLI Context Flush
+ * 
+ * @brief Starts the transfer of the pending output if none is in progress (output printed outside of commands for example)
+ * 
+ * @param cli_ctx_t* ctx : Instance [in]
+ * 
+ ************************************************/
+void cli_ctx_flush(cli_ctx_t* ctx);
+
+#endif
+
+/*************************************************
+ * CLI Get Default Context
+ * 
+ * @brief Returns the instance used by the functions without context (cli_insert_char, cli_treat_command...), to set its output
+ * 
+ * @return cli_ctx_t* : default instance
+ * 
+ ************************************************/
+cli_ctx_t* cli_get_default_ctx(void);
+
+/*************************************************
+ * CLI Get Current Context
+ * 
+ * @brief Returns the instance whose action is being executed, NULL outside of actions. It is also the instance read by the 
+ * cli_get_*_argument functions. Set CLI_THREAD_LOCAL if actions of different instances run concurrently in different tasks
+ * 
+ * @return cli_ctx_t* : instance executing the current action
+ * 
+ ************************************************/
+cli_ctx_t* cli_get_current_ctx(void);
+
+/*************************************************
+ * CLI Context Insert Char
+ * 
+ * @brief Same as cli_insert_char, for the given instance
+ * 
+ * @param cli_ctx_t* ctx : Instance [in]
+ * @param char c         : Character to be inserted [in]
+ * 
+ * @return cli_status_e : current CLI status 
+ * 
+ ************************************************/
+cli_status_e cli_ctx_insert_char(cli_ctx_t* ctx, char const c);
+
+/*************************************************
+ * CLI Context Insert Chars
+ * 
+ * @brief Same as cli_insert_chars, for the given instance
+ * 
+ * @param cli_ctx_t* ctx : Instance [in]
+ * @param char buf[]     : Characters to be inserted [in]
+ * @param size_t n       : Amount of characters [in]
+ * 
+ * @return size_t : amount of complete commands received
+ * 
+ ************************************************/
+size_t cli_ctx_insert_chars(cli_ctx_t* ctx, char const buf[], size_t n);
+
 #if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
 
+/*************************************************
+ * CLI Context Treat Command
+ * 
+ * @brief Same as cli_treat_command, for the given instance
+ * 
+ * @param cli_ctx_t* ctx : Instance [in]
+ * 
+ ************************************************/
+void cli_ctx_treat_command(cli_ctx_t* ctx);
+
+/*************************************************
+ * CLI Context Get Rx Status
+ * 
+ * @brief Same as cli_get_rx_status, for the given instance
+ * 
+ * @param cli_ctx_t* ctx          : Instance [in]
+ * @param cliRxStatus_t* status   : Occupancy of the reception queue [out]
+ * 
+ ************************************************/
+void cli_ctx_get_rx_status(cli_ctx_t* ctx, cliRxStatus_t* status);
+
+/*************************************************
+ * CLI Get Rx Status
+ * 
+ * @brief This function is only accessible if polling mode is active. It reports how many commands are waiting to be treated, so a 
+ * host sending scripts can pace itself on the queue instead of waiting for each answer
+ * 
+ * @param cliRxStatus_t* status : Occupancy of the reception queue [out]
+ * 
+ ************************************************/
+void cli_get_rx_status(cliRxStatus_t* status);
+
 /*************************************************
  * CLI treat command
  * 
- * @brief This function is only accessible if polling mode is active. Its job is to execute the command inside the CLI cliBuffer
+ * @brief This function is only accessible if polling mode is active. Its job is to execute the oldest command received, copying it
+ * from the reception ring to cliBuffer. With CLI_ZERO_COPY_EN, cliBuffer is the reception ring itself and the command is parsed in
+ * place, nothing is copied. It does nothing if no complete command is waiting
  * 
  * @param char cliBuffer[] : Buffer that contains the string [in]
- * @param size_t maxLen    : Maximum length accepted (sizeof(buffer) normally) [in]
+ * @param size_t maxLen    : Maximum length accepted (sizeof(buffer) normally), a power of 2 with CLI_ZERO_COPY_EN [in]
  * 
  ************************************************/
 void cli_treat_command(char cliBuffer[], size_t maxLen);
@@ -119,14 +562,103 @@ void cli_treat_command(char cliBuffer[], size_t maxLen);
  ************************************************/
 void cli_printf(char const * const str, ...);
 
+#if (defined(CLI_STATS_EN) && CLI_STATS_EN == 1)
+
+/*************************************************
+ * CLI Context Print Stats
+ * 
+ * @brief Prints the statistics of the actions on the output of an instance, then resets them. Times are in CLI_STATS_TIMER units
+ * 
+ * @param cli_ctx_t* ctx : Instance [in]
+ * 
+ ************************************************/
+void cli_ctx_print_stats(cli_ctx_t* ctx);
+
+/*************************************************
+ * CLI Print Stats
+ * 
+ * @brief Action of cliStatsElement(). Prints the statistics on the console the command came from, then resets them
+ * 
+ ************************************************/
+void cli_print_stats(void);
+
+#endif
+
+#if (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1)
+
+/*************************************************
+ * CLI Registry Init
+ * 
+ * @brief Sorts the index of the registered elements. Done by the first lookup otherwise, call it once at startup if the instances are
+ * treated from several tasks
+ * 
+ ************************************************/
+void cli_registry_init(void);
+
+#endif
+
+#if (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+
+/*************************************************
+ * CLI Typed Action
+ * 
+ * @brief Action of the typed elements, never called. The CLI calls the typed callback of the element with its decoded arguments instead
+ * 
+ ************************************************/
+void cli_typed_action(void);
+
+#endif
+
+#if (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+
+/*************************************************
+ * CLI Context Print Trace
+ * 
+ * @brief Dumps the trace ring on the output of an instance, oldest entry first, as hex text decoded by cli/tools/cli_trace_decode.py.
+ * The trace is kept, entries are only overwritten by newer ones
+ * 
+ * @param cli_ctx_t* ctx : Instance [in]
+ * 
+ ************************************************/
+void cli_ctx_print_trace(cli_ctx_t* ctx);
+
+/*************************************************
+ * CLI Print Trace
+ * 
+ * @brief Action of cliTraceElement(). Dumps the trace on the console the command came from
+ * 
+ ************************************************/
+void cli_print_trace(void);
+
+#endif
+
+#if (defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+
+/*************************************************
+ * CLI Write
+ * 
+ * @brief Sends already formatted text to the console. With the built-in formatter, the CLI output goes through this function instead of
+ * cli_printf. The weak implementation calls cli_printf, override it (UART write...) to not link the printf family at all
+ * 
+ * @param char data[] : Characters to send, not terminated [in]
+ * @param size_t len  : Amount of characters [in]
+ * 
+ ************************************************/
+void cli_write(char const data[], size_t len);
+
+#endif
+
 
 /*************************************************
  * CLI Insert Char
  * 
  * @brief This function inserts a character in the buffer. The insert will be cyclical, but once a \n arrives, the command will be ignored 
+ * if it is too big. In polling mode, characters go to the reception ring instead, and the function can be called from an interrupt
+ * while cli_treat_command executes a previous command (one producer and one consumer per instance). With CLI_ZERO_COPY_EN, cliBuffer
+ * is the reception ring itself : a maxLen that is not a power of 2 is refused (error printed, nothing received)
  * 
  * @param uint8_t cliBuffer[] : Buffer that contains the string [in]
- * @param size_t maxLen       : Maximum length accepted (sizeof(buffer) normally) [in]
+ * @param size_t maxLen       : Maximum length accepted (sizeof(buffer) normally), a power of 2 with CLI_ZERO_COPY_EN [in]
  * @param char c              : Character to be inserted [in]
  * 
  * @return cli_status_e : current CLI status 
@@ -134,6 +666,23 @@ void cli_printf(char const * const str, ...);
  ************************************************/
 cli_status_e cli_insert_char(char cliBuffer[], size_t maxLen, char const c);
 
+/*************************************************
+ * CLI Insert Chars
+ * 
+ * @brief Inserts a block of characters, as received by DMA for example. Same behavior as calling cli_insert_char for each one, but in 
+ * polling mode the line ends are searched a word at a time and the characters between them are copied at once in the reception ring
+ * (cliBuffer itself with CLI_ZERO_COPY_EN, whose maxLen must then be a power of 2)
+ * 
+ * @param char cliBuffer[] : Buffer that contains the string [in]
+ * @param size_t maxLen    : Maximum length accepted (sizeof(buffer) normally), a power of 2 with CLI_ZERO_COPY_EN [in]
+ * @param char buf[]       : Characters to be inserted [in]
+ * @param size_t n         : Amount of characters [in]
+ * 
+ * @return size_t : amount of complete commands received (queued in polling mode, executed otherwise)
+ * 
+ ************************************************/
+size_t cli_insert_chars(char cliBuffer[], size_t maxLen, char const buf[], size_t n);
+
 
 /*************************************************
  * CLI Get Int Argument
@@ -222,4 +771,8 @@ size_t cli_get_buffer_argument_big_endian(size_t argNum, uint8_t buff[], size_t
  ************************************************/
 size_t cli_get_string_argument(size_t argNum, uint8_t buff[], size_t buffLen, bool* res);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
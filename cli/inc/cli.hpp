@@ -0,0 +1,363 @@
+#ifndef SILABS_CLI_HPP
+#define SILABS_CLI_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "cli.h"
+
+#if (defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1)
+    #error "cli.hpp builds cliElement_t tables, it can not be used with CLI_COMPACT_EN"
+#endif
+
+/**********************************************
+ * GENERAL INFO
+ *********************************************/
+
+ /**
+  * C++17 declaration of the menus. The elements are built by constexpr functions and checked at compile time, the result is the
+  * same cliElement_t tables the C core reads :
+  *
+  *     static void sumFn(int32_t a, int32_t b){ ... }
+  *     static void helloFn(cli::String<32> const& s){ ... s.data ... }
+  *     static void rawFn(void){ ... cli_get_uint_argument(0, NULL) ... }
+  *
+  *     extern "C" cliElement_t subMenu[];
+  *
+  *     CLI_MAIN_MENU(
+  *         cli::sub(           "sub",      subMenu,                "sub menu"                  ),
+  *         cli::typed<sumFn>(  "sum",                              "adds 2 numbers"            ),
+  *         cli::typed<helloFn>("hello",                            "prints a string"           ),
+  *         cli::action(        "raw",      rawFn,      "u...",     "reads the arguments itself")
+  *     );
+  *
+  * CLI_MENU(name, ...) declares any other menu (cliElement_t name[]), CLI_MAIN_MENU(...) declares cliMainMenu with C linkage.
+  *
+  * Each menu fails to compile (static_assert) if :
+  *     - an element has no name, an empty name or a space in its name
+  *     - an arguments string is invalid (unknown type, integer width, incomplete ellipsis or ellipsis not at the end, more than
+  *       CLI_MAX_ARGUMENTS, 'f' without CLI_FLOAT_EN)
+  *     - a name is the prefix of another element of the same menu (case insensitive), the shorter one could never be selected
+  *
+  * A NULL sub menu, callback or arguments string given to cli::sub / cli::action does not compile either (deleted overloads). The
+  * builders return a cli::Element, which records whether it is an action : the static_asserts never compare the addresses of the
+  * menus, callbacks and generated arguments strings with NULL, this is not a constant expression with -fno-delete-null-pointer-checks
+  * (AVR, UBSan).
+  *
+  * cli::typed<fn> generates the arguments string from the parameters of fn and a void(void) action that reads them and calls fn. The
+  * parameters can be intN_t / uintN_t (width checked by the CLI), float (CLI_FLOAT_EN), cli::Buffer<N> and cli::String<N>, by value or
+  * const reference. A captureless lambda can be bound with its function pointer (cli::typed<+lambda>).
+  *
+  * Once every menu is declared with this header, CLI_ARGS_CHECK_EN can be set to 0 to remove the checks of the arguments strings
+  * from the firmware (except the integer widths, which the CLI always checks).
+  ***/
+
+/**********************************************
+ * DEFINES
+ *********************************************/
+
+#define CLI_MENU(name, ...)                                                                                                             \
+    static_assert(cli::detail::elements_valid({ __VA_ARGS__ }),                                                                         \
+                  "CLI menu '" #name "' : element without name or with a space in its name");                                           \
+    static_assert(cli::detail::specs_valid({ __VA_ARGS__ }),                                                                            \
+                  "CLI menu '" #name "' : invalid arguments string (type, width, ellipsis or more than CLI_MAX_ARGUMENTS)");            \
+    static_assert(cli::detail::prefixes_unique({ __VA_ARGS__ }),                                                                        \
+                  "CLI menu '" #name "' : a name is the prefix of another element of the menu, it could never be selected");            \
+    cliElement_t name[] = { __VA_ARGS__, cli::terminator() }
+
+#define CLI_MAIN_MENU(...)                                                                                                              \
+    extern "C" cliElement_t cliMainMenu[];                                                                                              \
+    CLI_MENU(cliMainMenu, __VA_ARGS__)
+
+namespace cli{
+
+/**********************************************
+ * TYPES
+ *********************************************/
+
+//Buffer argument of a typed action ('b'), len is the amount of bytes read
+template<size_t N>
+struct Buffer{
+    uint8_t data[N];
+    size_t  len;
+};
+
+//String argument of a typed action ('s'), data is always terminated by \0, len is the amount of bytes read
+template<size_t N>
+struct String{
+    char    data[N];
+    size_t  len;
+};
+
+//Element built by cli::sub, cli::action or cli::typed, converted to the cliElement_t of the menu
+struct Element{
+    cliElement_t    el;
+    bool            isAction;
+
+    constexpr operator cliElement_t() const{
+        return el;
+    }
+};
+
+namespace detail{
+
+/**********************************************
+ * COMPILE TIME CHECKS
+ *********************************************/
+
+constexpr char lower(char c){
+    return ( ('A' <= c && c <= 'Z') ? (char) (c - 'A' + 'a') : c );
+}
+
+constexpr bool is_digit(char c){
+    return ('0' <= c && c <= '9');
+}
+
+//Same rules as cli_get_args_spec
+constexpr bool spec_valid(char const* args){
+    size_t count = 0;
+
+    for(size_t i = 0; args[i] != '\0'; i++){
+        switch(args[i]){
+            #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
+            case 'f' :
+            #endif
+
+            case 's' :
+            case 'b' :
+            case '*' : {
+                if(++count > CLI_MAX_ARGUMENTS) return false;
+                break;
+            }
+
+            case 'u' :
+            case 'i' : {
+                if(++count > CLI_MAX_ARGUMENTS) return false;
+                if(!is_digit(args[i + 1])) break;
+
+                unsigned width = 0;
+
+                while(is_digit(args[i + 1]) && width < 100) width = width * 10 + (unsigned) (args[++i] - '0');
+
+                if(width != 8 && width != 16 && width != 32 && width != 64) return false;
+                break;
+            }
+
+            case '.' : return (args[i + 1] == '.' && args[i + 2] == '.' && args[i + 3] == '\0');
+
+            default : return false;
+        }
+    }
+
+    return true;
+}
+
+template<size_t N>
+constexpr bool elements_valid(Element const (&elements)[N]){
+    for(size_t i = 0; i < N; i++){
+        cliElement_t const& e = elements[i].el;
+
+        if(e.name == nullptr || e.name[0] == '\0') return false;
+
+        for(size_t k = 0; e.name[k] != '\0'; k++){
+            if(e.name[k] == ' ') return false;
+        }
+    }
+
+    return true;
+}
+
+template<size_t N>
+constexpr bool specs_valid(Element const (&elements)[N]){
+    for(size_t i = 0; i < N; i++){
+        if(elements[i].isAction && !spec_valid(elements[i].el.args)) return false;
+    }
+
+    return true;
+}
+
+//True if 'tkn' selects 'str' (cli_str_starts_with)
+constexpr bool starts_with(char const* tkn, char const* str){
+    size_t i = 0;
+
+    for(; tkn[i] != '\0'; i++){
+        if(str[i] == '\0' || lower(tkn[i]) != lower(str[i])) return false;
+    }
+
+    return (i > 0);
+}
+
+template<size_t N>
+constexpr bool prefixes_unique(Element const (&elements)[N]){
+    for(size_t i = 0; i < N; i++){
+        for(size_t k = 0; k < N; k++){
+            if(i == k || elements[i].el.name == nullptr || elements[k].el.name == nullptr) continue;
+            if(starts_with(elements[i].el.name, elements[k].el.name)) return false;
+        }
+    }
+
+    return true;
+}
+
+//Every field of the element, typed (CLI_TYPED_EN) included
+constexpr cliElement_t element(char const* name, cliElement_t const* ref, void (*fn)(void), char const* args, char const* desc,
+                               cliArgumentsDetails_t const* details){
+    #if (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+    return cliElement_t{ name, ref, fn, args, desc, details, nullptr };
+    #else
+    return cliElement_t{ name, ref, fn, args, desc, details };
+    #endif
+}
+
+/**********************************************
+ * TYPED ACTIONS
+ *********************************************/
+
+constexpr size_t length(char const* str){
+    size_t len = 0;
+    while(str[len] != '\0') len++;
+    return len;
+}
+
+//Arguments string and getter of each parameter type
+template<typename T, typename Enable = void>
+struct Arg{
+    static_assert(sizeof(T) == 0, "Unsupported argument type, use intN_t, uintN_t, float, cli::Buffer<N> or cli::String<N>");
+};
+
+template<typename T>
+struct Arg<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>{
+    static constexpr char spec[4] = {
+        ( std::is_signed<T>::value ? 'i' : 'u' ),
+        ( sizeof(T) == 1 ? '8' : sizeof(T) == 2 ? '1' : sizeof(T) == 4 ? '3' : '6' ),
+        ( sizeof(T) == 1 ? '\0' : sizeof(T) == 2 ? '6' : sizeof(T) == 4 ? '2' : '4' ),
+        '\0'
+    };
+
+    static bool get(size_t i, T& value){
+        bool res = false;
+        value = ( std::is_signed<T>::value ? (T) cli_get_int_argument(i, &res) : (T) cli_get_uint_argument(i, &res) );
+        return res;
+    }
+};
+
+#if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
+template<>
+struct Arg<float>{
+    static constexpr char spec[2] = "f";
+
+    static bool get(size_t i, float& value){
+        bool res = false;
+        value = cli_get_float_argument(i, &res);
+        return res;
+    }
+};
+#endif
+
+template<size_t N>
+struct Arg<Buffer<N>>{
+    static constexpr char spec[2] = "b";
+
+    static bool get(size_t i, Buffer<N>& value){
+        bool res = false;
+        value.len = cli_get_buffer_argument(i, value.data, N, &res);
+        return res;
+    }
+};
+
+template<size_t N>
+struct Arg<String<N>>{
+    static constexpr char spec[2] = "s";
+
+    static bool get(size_t i, String<N>& value){
+        bool res = false;
+        value.len = cli_get_string_argument(i, (uint8_t*) value.data, N, &res);
+        return res;
+    }
+};
+
+//Arguments string generated from the parameters of a typed action
+template<size_t N>
+struct Spec{
+    char str[N];
+};
+
+template<typename... A>
+constexpr auto make_spec(void){
+    Spec<(size_t(0) + ... + length(Arg<A>::spec)) + 1> s{};
+    size_t n = 0;
+
+    for(char const* arg : { static_cast<char const*>(Arg<A>::spec)..., "" }){
+        for(size_t i = 0; arg[i] != '\0'; i++) s.str[n++] = arg[i];
+    }
+
+    return s;
+}
+
+template<typename Fn>
+struct Bind;
+
+//Arguments string of fn and action reading its arguments. The arguments were verified against the same string, the getters can only
+//fail on a buffer bigger than its cli::Buffer / cli::String (already reported by the getter), fn is then not called
+template<typename... A>
+struct Bind<void (*)(A...)>{
+    static constexpr auto spec = make_spec<std::decay_t<A>...>();
+
+    template<void (*F)(A...), size_t... I>
+    static void call(std::index_sequence<I...>){
+        std::tuple<std::decay_t<A>...> args{};
+        bool ok = true;
+
+        ( (ok = Arg<std::decay_t<A>>::get(I, std::get<I>(args)) && ok), ... );
+
+        if(ok) F(std::get<I>(args)...);
+    }
+
+    template<void (*F)(A...)>
+    static void action(void){
+        call<F>(std::index_sequence_for<A...>{});
+    }
+};
+
+} //namespace detail
+
+/**********************************************
+ * ELEMENTS
+ *********************************************/
+
+//Sub menu, same as cliSubMenuElement
+constexpr Element sub(char const* name, cliElement_t const* ref, char const* desc){
+    return Element{ detail::element(name, ref, nullptr, nullptr, desc, nullptr), false };
+}
+
+Element sub(char const* name, std::nullptr_t ref, char const* desc) = delete;
+
+//Action reading its arguments with cli_get_*_argument, same as cliActionElement / cliActionElementDetailed
+constexpr Element action(char const* name, void (*fn)(void), char const* args, char const* desc, cliArgumentsDetails_t const* details = nullptr){
+    return Element{ detail::element(name, nullptr, fn, args, desc, details), true };
+}
+
+Element action(char const* name, std::nullptr_t fn, char const* args, char const* desc, cliArgumentsDetails_t const* details = nullptr) = delete;
+Element action(char const* name, void (*fn)(void), std::nullptr_t args, char const* desc, cliArgumentsDetails_t const* details = nullptr) = delete;
+
+//Action receiving its arguments as parameters, the arguments string is generated from them
+template<auto F>
+constexpr Element typed(char const* name, char const* desc, cliArgumentsDetails_t const* details = nullptr){
+    using B = detail::Bind<decltype(F)>;
+
+    return Element{ detail::element(name, nullptr, &B::template action<F>, B::spec.str, desc, details), true };
+}
+
+//End of a menu, same as cliMenuTerminator
+constexpr cliElement_t terminator(void){
+    return detail::element(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+}
+
+} //namespace cli
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef SILABS_CLI_COMPACT_H
+#define SILABS_CLI_COMPACT_H
+
+#include <stddef.h>
+
+#include "cli.h"
+
+/**********************************************
+ * GENERAL INFO
+ *********************************************/
+
+ /**
+  * Builds the compact menu tables (CLI_COMPACT_EN) from X-macros. Include it once, in the file listing the menus :
+  *
+  *     //Every menu, 'main' is the main menu
+  *     #define CLI_COMPACT_MENUS(MENU)                                                          \
+  *         MENU(main)                                                                           \
+  *         MENU(subMenu)
+  *
+  *     //Elements of a menu : SUB(menu, name, desc) for a sub menu listed in CLI_COMPACT_MENUS,
+  *     //ACTION(fn, name, args, desc) for an action
+  *     #define CLI_COMPACT_MENU_main(SUB, ACTION)                                               \
+  *         SUB(    subMenu,    "sub",      "sub menu"                              )            \
+  *         ACTION( addFn,      "add",      "ii",       "adds 2 numbers"            )
+  *
+  *     #define CLI_COMPACT_MENU_subMenu(SUB, ACTION)                                            \
+  *         ACTION( average,    "average",  "u...",     "average of the numbers"    )
+  *
+  *     #include "cli_compact.h"
+  *
+  * Every string is copied once in a pool (a struct of char arrays, so offsetof gives the 16 bits offset of each string at compile time),
+  * the menus are laid out one after the other in a table of 8 bytes elements, and the actions are called through a table of function
+  * pointers. Everything is const and stays in flash. Names and descriptions must be string literals, and an action function can
+  * only appear once in the tree.
+  ***/
+
+#if (defined(CLI_EN) && CLI_EN == 1) && (defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1)
+
+/**********************************************
+ * DEFINES
+ *********************************************/
+
+#define CLI_COMPACT_NOTHING(...)
+
+//String pool
+#define CLI_COMPACT_POOL_SUB(menu, name, desc)                  char menu##_menuName[sizeof(name)]; char menu##_menuDesc[sizeof(desc)];
+#define CLI_COMPACT_POOL_ACTION(fn, name, args, desc)           char fn##_name[sizeof(name)]; char fn##_args[sizeof(args)]; char fn##_desc[sizeof(desc)];
+#define CLI_COMPACT_POOL_MENU(menu)                             CLI_COMPACT_MENU_##menu(CLI_COMPACT_POOL_SUB, CLI_COMPACT_POOL_ACTION)
+
+#define CLI_COMPACT_POOL_INIT_SUB(menu, name, desc)             name, desc,
+#define CLI_COMPACT_POOL_INIT_ACTION(fn, name, args, desc)      name, args, desc,
+#define CLI_COMPACT_POOL_INIT_MENU(menu)                        CLI_COMPACT_MENU_##menu(CLI_COMPACT_POOL_INIT_SUB, CLI_COMPACT_POOL_INIT_ACTION)
+
+#define CLI_COMPACT_STRING(field)                               ( (uint16_t) offsetof(struct cliCompactPool, field) )
+
+//Actions
+#define CLI_COMPACT_ACTION_ENUM(fn, name, args, desc)           CLI_COMPACT_ACTION_##fn,
+#define CLI_COMPACT_ACTION_ENUM_MENU(menu)                      CLI_COMPACT_MENU_##menu(CLI_COMPACT_NOTHING, CLI_COMPACT_ACTION_ENUM)
+
+#define CLI_COMPACT_ACTION_FN(fn, name, args, desc)             fn,
+#define CLI_COMPACT_ACTION_FN_MENU(menu)                        CLI_COMPACT_MENU_##menu(CLI_COMPACT_NOTHING, CLI_COMPACT_ACTION_FN)
+
+//Elements, each menu is followed by its terminator
+#define CLI_COMPACT_COUNT_SUB(menu, name, desc)                 1 +
+#define CLI_COMPACT_COUNT_ACTION(fn, name, args, desc)          1 +
+#define CLI_COMPACT_TABLE_MENU(menu)                            cliElement_t menu[CLI_COMPACT_MENU_##menu(CLI_COMPACT_COUNT_SUB, CLI_COMPACT_COUNT_ACTION) 1];
+
+#define CLI_COMPACT_MENU_INDEX(menu)                            ( (uint16_t) (offsetof(struct cliCompactTable, menu) / sizeof(cliElement_t)) )
+
+#define CLI_COMPACT_TABLE_INIT_SUB(menu, name, desc)            { CLI_COMPACT_STRING(menu##_menuName), CLI_COMPACT_STRING(menu##_menuDesc), CLI_COMPACT_NONE, CLI_COMPACT_MENU_INDEX(menu) },
+#define CLI_COMPACT_TABLE_INIT_ACTION(fn, name, args, desc)     { CLI_COMPACT_STRING(fn##_name), CLI_COMPACT_STRING(fn##_desc), CLI_COMPACT_STRING(fn##_args), CLI_COMPACT_ACTION_##fn },
+#define CLI_COMPACT_TABLE_INIT_MENU(menu)                       { CLI_COMPACT_MENU_##menu(CLI_COMPACT_TABLE_INIT_SUB, CLI_COMPACT_TABLE_INIT_ACTION) CLI_COMPACT_TERMINATOR },
+
+#define CLI_COMPACT_TERMINATOR                                  { CLI_COMPACT_NONE, CLI_COMPACT_NONE, CLI_COMPACT_NONE, CLI_COMPACT_NONE }
+
+/**********************************************
+ * TYPES
+ *********************************************/
+
+struct cliCompactPool{
+    char mainName[sizeof("main")];
+    char mainDesc[sizeof("main menu")];
+    CLI_COMPACT_MENUS(CLI_COMPACT_POOL_MENU)
+};
+
+enum{
+    CLI_COMPACT_MENUS(CLI_COMPACT_ACTION_ENUM_MENU)
+    CLI_COMPACT_ACTIONS_COUNT
+};
+
+struct cliCompactTable{
+    cliElement_t root[1];
+    CLI_COMPACT_MENUS(CLI_COMPACT_TABLE_MENU)
+};
+
+//Offsets, indexes and action numbers must fit in 16 bits and not reach CLI_COMPACT_NONE
+typedef char cliCompactPoolTooBig_t[( sizeof(struct cliCompactPool) < CLI_COMPACT_NONE ) ? 1 : -1];
+typedef char cliCompactTableTooBig_t[( sizeof(struct cliCompactTable) / sizeof(cliElement_t) < CLI_COMPACT_NONE ) ? 1 : -1];
+typedef char cliCompactTooManyActions_t[( CLI_COMPACT_ACTIONS_COUNT < CLI_COMPACT_NONE ) ? 1 : -1];
+
+/**********************************************
+ * PRIVATE VARIABLES
+ *********************************************/
+
+static const struct cliCompactPool cliCompactPoolData = {
+    "main",
+    "main menu",
+    CLI_COMPACT_MENUS(CLI_COMPACT_POOL_INIT_MENU)
+};
+
+static const struct cliCompactTable cliCompactTableData = {
+    { { CLI_COMPACT_STRING(mainName), CLI_COMPACT_STRING(mainDesc), CLI_COMPACT_NONE, CLI_COMPACT_MENU_INDEX(main) } },
+    CLI_COMPACT_MENUS(CLI_COMPACT_TABLE_INIT_MENU)
+};
+
+/**********************************************
+ * GLOBAL VARIABLES
+ *********************************************/
+
+char const * const cliCompactStrings = (char const*) &cliCompactPoolData;
+
+cliElement_t const * const cliCompactElements = (cliElement_t const*) &cliCompactTableData;
+
+cliAction_t cliCompactActions[] = {
+    CLI_COMPACT_MENUS(CLI_COMPACT_ACTION_FN_MENU)
+    NULL
+};
+
+#endif
+
+#endif
@@ -8,19 +8,177 @@
 #define CLI_AMOUNT_OF_ALIGN_CHARS 22
 #endif
 
+//Maximum amount of arguments a single command can carry (ellipsis included). An index of this size is built once per command
+//during verification, so every argument getter is a direct lookup instead of a walk through the arguments string
+#ifndef CLI_MAX_ARGUMENTS
+#define CLI_MAX_ARGUMENTS 16
+#endif
+
+//Enables the word at a time decoder of { ... } buffers. Bytes written as 2 digits separated by one space ({ 0A 0B 0C ... }) are
+//then decoded 4 at a time, any other layout falls back to the byte per byte parser
+#ifndef CLI_BUFFER_SWAR_EN
+#define CLI_BUFFER_SWAR_EN 1
+#endif
+
 //Enables and disables Float support (useful for MCUs that do not have FPU)
 #ifndef CLI_FLOAT_EN
 #define CLI_FLOAT_EN 0
 #endif
 
+//Enables the prefix trie lookup. Menu names are resolved through the flash tables generated by cli/tools/cli_trie_gen.c (cliTrie and
+//cliTrieMenuRoot) instead of scanning every element of the menu. The generated file must be rebuilt each time the menus change
+#ifndef CLI_TRIE_EN
+#define CLI_TRIE_EN 0
+#endif
+
+//Storage class of the pointer to the instance executing an action (read by the cli_get_*_argument functions). Leave it empty if every
+//instance is treated from the same task, set it to _Thread_local (C11) or __thread when instances are treated from different RTOS tasks
+#ifndef CLI_THREAD_LOCAL
+#define CLI_THREAD_LOCAL
+#endif
+
+//Lock around the tables shared by all instances (statistics, trace). Leave it empty if every instance is treated from the same task,
+//take a mutex (or mask the interrupts) when instances are treated from different RTOS tasks. It is never taken while printing
+#ifndef CLI_LOCK
+#define CLI_LOCK()
+#endif
+
+#ifndef CLI_UNLOCK
+#define CLI_UNLOCK()
+#endif
+
+//Enables the built-in formatter. The CLI formats its output itself (%s %c %d %u %X with width, no float) and sends the text to cli_write
+//or to the TX ring, so the printf family is not needed when cli_write is overridden
+#ifndef CLI_FORMATTER_EN
+#define CLI_FORMATTER_EN 0
+#endif
+
+//Size of the TX ring of each CLI instance (power of 2, 0 to disable). Once a flush function is given (cli_ctx_set_flush), the output is
+//written in the ring and sent by big blocks (DMA for example) instead of one cli_printf call per piece of text. The CLI never waits
+//for a transfer : the output that does not fit in the ring is dropped and counted in txDropped of the instance
+#ifndef CLI_TX_BUFFER_SIZE
+#define CLI_TX_BUFFER_SIZE 0
+#endif
+
+//Enables the help generated at build time. Menu listings and action usages are printed in one write from the const strings generated by
+//cli/tools/cli_help_gen.c instead of being rebuilt element by element. The generated file must be rebuilt each time the menus change
+#ifndef CLI_HELP_PREBUILT_EN
+#define CLI_HELP_PREBUILT_EN 0
+#endif
+
+//Enables the statistics of the actions : amount of executions, and min / mean / max time spent parsing the command (lookup and arguments
+//verification) and executing the action. The table is shared by all instances (see CLI_LOCK), printed and reset by cliStatsElement().
+//Nothing is compiled when disabled
+#ifndef CLI_STATS_EN
+#define CLI_STATS_EN 0
+#endif
+
+//Amount of actions followed by the statistics. Actions executed once the table is full are only counted in the 'others' line
+#ifndef CLI_STATS_MAX_ELEMENTS
+#define CLI_STATS_MAX_ELEMENTS 16
+#endif
+
+//Time stamp read by the statistics and the trace (32 bits, wrapping), e.g. DWT->CYCCNT on Cortex-M or a clock_gettime in ns on a host.
+//With the default 0 only the executions are counted
+#ifndef CLI_STATS_TIMER
+#define CLI_STATS_TIMER() 0
+#endif
+
+//Enables the trace of the actions : a ring of the last CLI_TRACE_SIZE executions (time stamp, action, arguments accepted or not, parse and
+//execution times) shared by all instances (see CLI_LOCK), dumped by the cliTraceElement() action and decoded by
+//cli/tools/cli_trace_decode.py
+#ifndef CLI_TRACE_EN
+#define CLI_TRACE_EN 0
+#endif
+
+//Amount of entries of the trace ring (power of 2), 16 bytes each
+#ifndef CLI_TRACE_SIZE
+#define CLI_TRACE_SIZE 64
+#endif
+
+//Amount of actions named by the trace, each entry stores the 16 bits index of its action in this table. Actions executed once the table
+//is full are traced without name
+#ifndef CLI_TRACE_MAX_ELEMENTS
+#define CLI_TRACE_MAX_ELEMENTS 32
+#endif
+
+//Enables the typed actions (cliTypedActionElement). Their callback receives a structure of already decoded arguments, generated from the
+//arguments list by CLI_TYPED_ARGS, instead of reading them with cli_get_*_argument. Adds one pointer to every element
+#ifndef CLI_TYPED_EN
+#define CLI_TYPED_EN 0
+#endif
+
+//Enables the checks of the arguments strings (unknown type, ellipsis) done the first time an action is used. They can be removed when
+//every menu is declared with cli/inc/cli.hpp, which checks the same rules at compile time. The integer widths are always checked, an
+//unsupported one could not be parsed
+#ifndef CLI_ARGS_CHECK_EN
+#define CLI_ARGS_CHECK_EN 1
+#endif
+
+//Enables the compact menu tables. Menus are listed with X-macros and cli/inc/cli_compact.h builds const tables from them (string pool,
+//8 bytes per element with 16 bit offsets and indexes, table of actions) that stay in flash, instead of 24 bytes of RAM per cliElement_t
+//on 32 bits MCUs. Arguments descriptions, typed actions, cli.hpp and cli_trie_gen are not available with this layout
+#ifndef CLI_COMPACT_EN
+#define CLI_COMPACT_EN 0
+#endif
+
+//Enables the registration of elements from any source file (cliRegisterAction & co in cli.h). The registered elements are placed in the
+//cli_registry linker section, indexed once by name (case insensitive) and found by binary search next to the elements of cliMainMenu.
+//The GNU linker defines __start_cli_registry and __stop_cli_registry itself, a custom linker script must KEEP the section and define both
+#ifndef CLI_REGISTRY_EN
+#define CLI_REGISTRY_EN 0
+#endif
+
+//Maximum amount of registered elements, 2 bytes of RAM each for the index. Elements over this amount are ignored
+#ifndef CLI_REGISTRY_MAX_ELEMENTS
+#define CLI_REGISTRY_MAX_ELEMENTS 64
+#endif
+
 //Enables polling mode. In normal mode, the command is executed right after receiving \n character. Since the treatment can be quite lengthy
 //ranging from 60 to 400 us, it may not be fitted for some applications (may not be a good idea to execute it in interrupt mode)
-//the polling mode allows the user to chose the right moment to treat the received command. The CLI won't accept new characters ultil
-//the command is executed
+//the polling mode allows the user to chose the right moment to treat the received command. Received lines wait in a ring (see
+//CLI_RX_RING_SIZE) and each call of cli_treat_command executes the oldest one
 #ifndef CLI_POLLING_EN
 #define CLI_POLLING_EN 1
 #endif
 
+//Enables the incremental parsing, in normal mode only (CLI_POLLING_EN 0). Each name is looked up as soon as the space after it is received,
+//and each argument is verified as soon as it is complete, so when \n is received only the action is left to call. The treatment is spread
+//between the characters instead of being done at once at the end of the line. Commands that do not parse are treated again from the
+//beginning at the end of the line, with the usual messages
+#ifndef CLI_INCREMENTAL_EN
+#define CLI_INCREMENTAL_EN 0
+#endif
+
+//Size of the reception ring of each CLI instance in polling mode (power of 2). Characters are pushed in the ring by cli_insert_char and
+//complete lines are taken out by cli_treat_command, so new commands can be received while the previous one is executed. A line
+//can not be longer than the command buffer nor the ring, and characters are dropped only when the ring is full
+#ifndef CLI_RX_RING_SIZE
+#define CLI_RX_RING_SIZE 256
+#endif
+
+//Enables zero copy reception in polling mode. The command buffer given to the CLI becomes the reception ring (its size must then be a
+//power of 2) and commands are parsed in place, instead of being copied from an internal ring of CLI_RX_RING_SIZE bytes to the buffer.
+//It saves the ring RAM and one copy per command, but the place of a command in the ring is released only once it is executed.
+//Commands are kept contiguous : a line reaching the end of the buffer is moved to its beginning. With no command waiting, any line
+//shorter than the buffer is received. While commands are waiting, a line reaching the end must also fit before the oldest of them, so
+//in the worst case only lines shorter than half of the space they leave free are guaranteed to be received
+#ifndef CLI_ZERO_COPY_EN
+#define CLI_ZERO_COPY_EN 0
+#endif
+
+//Maximum amount of complete commands waiting in the reception ring of an instance. Commands received while the queue is full are
+//dropped (CLI_RX_FULL). A host can send whole scripts without waiting for each answer as long as it stays under this depth
+#ifndef CLI_RX_QUEUE_DEPTH
+#define CLI_RX_QUEUE_DEPTH 8
+#endif
+
+//Memory barrier ordering the ring accesses between the reception interrupt and the treatment. The GCC builtin emits a DMB on Cortex-M,
+//a compiler barrier (__asm volatile("" ::: "memory")) is enough on single core MCUs
+#ifndef CLI_MEMORY_BARRIER
+#define CLI_MEMORY_BARRIER() __sync_synchronize()
+#endif
+
 //Enables the most basic printing (menus, actions and arguments descriptions)
 #ifndef CLI_MENU_PRINT_ENABLE
 #define CLI_MENU_PRINT_ENABLE 1
@@ -7,7 +7,7 @@
 
 #include "cli.h"
 
-#if ( defined(CLI_EN) && (CLI_EN == 1) )
+#if ( defined(CLI_EN) && (CLI_EN == 1) ) && !( defined(CLI_COMPACT_EN) && (CLI_COMPACT_EN == 1) )
 
 /**********************************************************
  * GLOBAL VARIABLES
@@ -6,18 +6,64 @@
  * DEFINES
  *********************************************/
 
-#define BASE_PRINT(S, ...)       		cli_printf(S,## __VA_ARGS__)
-#define BASE_PRINTF(S, ...)      		cli_printf(S,## __VA_ARGS__)
-#define BASE_PRINTLN(S, ...)    		cli_printf(S"\r\n", ##__VA_ARGS__)
+#if (defined(CLI_INCREMENTAL_EN) && CLI_INCREMENTAL_EN == 1) && (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+    #error "CLI_INCREMENTAL_EN needs CLI_POLLING_EN 0"
+#endif
+
+#if (defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1) && (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+    #error "CLI_TYPED_EN is not supported by the compact tables (CLI_COMPACT_EN)"
+#endif
+
+#if (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1) && ( (defined(CLI_TRIE_EN) && CLI_TRIE_EN == 1) || (defined(CLI_HELP_PREBUILT_EN) && CLI_HELP_PREBUILT_EN == 1) || (defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1) )
+    #error "CLI_REGISTRY_EN can not be used with the generated tables (CLI_TRIE_EN, CLI_HELP_PREBUILT_EN, CLI_COMPACT_EN)"
+#endif
+
+//Fields of an element, read from the compact tables (cli_compact.h) or from the cliElement_t itself
+#if (defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1)
+    #define CLI_COMPACT_STR(off)        ( ((off) == CLI_COMPACT_NONE) ? NULL : &cliCompactStrings[(off)] )
+    #define CLI_EL_NAME(e)              CLI_COMPACT_STR((e)->name)
+    #define CLI_EL_DESC(e)              CLI_COMPACT_STR((e)->desc)
+    #define CLI_EL_ARGS(e)              CLI_COMPACT_STR((e)->args)
+    #define CLI_EL_ARGS_DESC(e)         ( (cliArgumentsDetails_t const*) NULL )
+    #define CLI_EL_SUB(e)               ( ((e)->args != CLI_COMPACT_NONE || (e)->ref == CLI_COMPACT_NONE) ? NULL : &cliCompactElements[(e)->ref] )
+    #define CLI_EL_ACTION(e)            ( ((e)->args == CLI_COMPACT_NONE) ? NULL : cliCompactActions[(e)->ref] )
+    #define CLI_MAIN_ELEMENT            ( (cliElement_t*) &cliCompactElements[0] )
+#else
+    #define CLI_EL_NAME(e)              ((e)->name)
+    #define CLI_EL_DESC(e)              ((e)->desc)
+    #define CLI_EL_ARGS(e)              ((e)->args)
+    #define CLI_EL_ARGS_DESC(e)         ((e)->argsDesc)
+    #define CLI_EL_SUB(e)               ((e)->subMenuRef)
+    #define CLI_EL_ACTION(e)            ((e)->action)
+    #define CLI_MAIN_ELEMENT            ( (cliElement_t*) &cliMainElement )
+#endif
+
+#if (defined(CLI_INCREMENTAL_EN) && CLI_INCREMENTAL_EN == 1) && !(defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+    #define CLI_CTX_MUTED(ctx)          ( (ctx) != NULL && (ctx)->incMuted )
+#else
+    #define CLI_CTX_MUTED(ctx)          false
+#endif
+
+//Every print goes to the output of the context 'ctx' in scope, or to cli_printf (cli_write with the built-in formatter) if it has none
+#if (defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+    #define BASE_PRINT(S, ...)       	do{ if(!CLI_CTX_MUTED(ctx)) cli_ctx_printf(ctx, S,## __VA_ARGS__); }while(0)
+#else
+    #define BASE_PRINT(S, ...)       	do{ if(CLI_CTX_MUTED(ctx)) break; if(CLI_CTX_HAS_OUTPUT(ctx)) cli_ctx_printf(ctx, S,## __VA_ARGS__); else cli_printf(S,## __VA_ARGS__); }while(0)
+#endif
+
+#define BASE_PRINTF(S, ...)      		BASE_PRINT(S,## __VA_ARGS__)
+#define BASE_PRINTLN(S, ...)    		BASE_PRINT(S"\r\n",## __VA_ARGS__)
 
 #if (defined(CLI_MENU_PRINT_ENABLE) && CLI_MENU_PRINT_ENABLE == 1)
     #define MENU_PRINT(S, ...)       	BASE_PRINT(S,## __VA_ARGS__)
     #define MENU_PRINTF(S, ...)      	BASE_PRINTF(S,## __VA_ARGS__)
     #define MENU_PRINTLN(S, ...)     	BASE_PRINTLN(S,## __VA_ARGS__)
+    #define MENU_WRITE(D, L)         	do{ if(!CLI_CTX_MUTED(ctx)) cli_ctx_write(ctx, D, L); }while(0)
 #else
     #define MENU_PRINT(S, ...)
     #define MENU_PRINTF(S, ...)
     #define MENU_PRINTLN(S, ...)    
+    #define MENU_WRITE(D, L)
 #endif
 
 #if (defined(CLI_ERROR_PRINT_ENABLE) && CLI_ERROR_PRINT_ENABLE == 1)
@@ -40,25 +86,186 @@
     #define DBG_PRINTLN(S, ...)    
 #endif
 
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1) && ( (CLI_RX_RING_SIZE & (CLI_RX_RING_SIZE - 1)) != 0 )
+    #error "CLI_RX_RING_SIZE must be a power of 2"
+#endif
+
+//Reception ring of an instance : its own ring, or the command buffer itself in zero copy mode
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1) && (defined(CLI_ZERO_COPY_EN) && CLI_ZERO_COPY_EN == 1)
+    #define CLI_RX_BUFFER(ctx)          ( (ctx)->buffer )
+    #define CLI_RX_SIZE(ctx)            ( (ctx)->size )
+#else
+    #define CLI_RX_BUFFER(ctx)          ( (ctx)->rxRing )
+    #define CLI_RX_SIZE(ctx)            ( (size_t) CLI_RX_RING_SIZE )
+#endif
+
+#define CLI_RX_INDEX(ctx, i)            ( (i) & (CLI_RX_SIZE(ctx) - 1) )
+
+#if (defined(CLI_TX_BUFFER_SIZE) && CLI_TX_BUFFER_SIZE > 0)
+    #if ( (CLI_TX_BUFFER_SIZE & (CLI_TX_BUFFER_SIZE - 1)) != 0 )
+        #error "CLI_TX_BUFFER_SIZE must be a power of 2"
+    #endif
+
+    #define CLI_CTX_HAS_OUTPUT(ctx)     ( (ctx) != NULL && ( (ctx)->print != NULL || (ctx)->flush != NULL ) )
+#else
+    #define CLI_CTX_HAS_OUTPUT(ctx)     ( (ctx) != NULL && (ctx)->print != NULL )
+#endif
+
+//Size of the line formatted at once by cli_ctx_printf without the built-in formatter, longer prints are streamed by cli_format
+#define CLI_CTX_PRINT_LINE_LEN          256
+
+//SWAR (SIMD within a register) constants, one bit / value per byte of a 32 bits word
+#define CLI_SWAR_L              0x01010101UL
+#define CLI_SWAR_H              0x80808080UL
+
+#if (defined(CLI_STATS_EN) && CLI_STATS_EN == 1) || (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+    #define CLI_TREAT_START(ctx)        ( (ctx)->treatStart = (uint32_t) CLI_STATS_TIMER() )
+#else
+    #define CLI_TREAT_START(ctx)
+#endif
+
+#if (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1) && ( (CLI_TRACE_SIZE & (CLI_TRACE_SIZE - 1)) != 0 )
+    #error "CLI_TRACE_SIZE must be a power of 2"
+#endif
+
+#if (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1) && (CLI_TRACE_MAX_ELEMENTS >= 0xFFFF)
+    #error "CLI_TRACE_MAX_ELEMENTS must fit in 16 bits"
+#endif
+
+#if (defined(CLI_INCREMENTAL_EN) && CLI_INCREMENTAL_EN == 1)
+    //States of the incremental parse
+    #define CLI_INC_IDLE                0   //Before a name
+    #define CLI_INC_NAME                1   //Receiving a name
+    #define CLI_INC_ARGS                2   //Action found, before an argument
+    #define CLI_INC_ARG                 3   //Receiving an argument
+    #define CLI_INC_READY               4   //Line complete and verified, only the action is left to call
+    #define CLI_INC_FAILED              5   //The line will be parsed again at its end
+    #define CLI_INC_TOO_BIG             6   //The line does not fit in the buffer, it is dropped at its end
+#endif
+
+//Version of the trace dump, to be changed with the layout of the entries in cli_ctx_print_trace and cli_trace_decode.py
+#define CLI_TRACE_VERSION               1
+
+/**********************************************
+ * PRIVATE TYPES
+ *********************************************/
+
+#if (defined(CLI_STATS_EN) && CLI_STATS_EN == 1)
+//Times measured for one action, in CLI_STATS_TIMER units
+typedef struct{
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+}cliStatsTime_t;
+
+typedef struct{
+    cliElement_t const* el;
+    uint32_t            count;
+    cliStatsTime_t      parse;  //From the start of the treatment to the call of the action
+    cliStatsTime_t      exec;   //Action
+}cliStats_t;
+#endif
+
+#if (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+//One execution (or refused command) of an action, in CLI_STATS_TIMER units
+typedef struct{
+    uint32_t            start;  //Start of the treatment of the command
+    uint32_t            parse;  //From the start of the treatment to the call of the action
+    uint32_t            exec;   //Action, 0 if the arguments were refused
+    uint16_t            id;     //Index of the action in cliTraceElements, CLI_TRACE_NO_ID if the table was full
+    uint8_t             flags;  //CLI_TRACE_VERIFIED
+    uint8_t             args;   //Amount of arguments
+}cliTrace_t;
+
+#define CLI_TRACE_VERIFIED              (1 << 0)
+#define CLI_TRACE_NO_ID                 0xFFFF
+#endif
+
 /**********************************************
  * EXTERNAL VARIABLES
  *********************************************/
 
+#if (defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1)
+extern char const * const cliCompactStrings;
+extern cliElement_t const * const cliCompactElements;
+extern cliAction_t cliCompactActions[];
+#else
 extern cliElement_t cliMainMenu[];
+#endif
+
+#if (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1)
+//Bounds of the cli_registry section, NULL if nothing is registered
+extern cliElement_t const __start_cli_registry[] __attribute__((weak));
+extern cliElement_t const __stop_cli_registry[] __attribute__((weak));
+#endif
+
+#if (defined(CLI_HELP_PREBUILT_EN) && CLI_HELP_PREBUILT_EN == 1)
+extern const char* const cliHelpMenu[];
+extern const uint16_t cliHelpMenuLen[];
+extern const uint16_t cliHelpMenuFirst[];
+extern const cliHelpElement_t cliHelpElements[];
+extern const uint16_t cliHelpMenuCount;
+#endif
+
+#if (defined(CLI_TRIE_EN) && CLI_TRIE_EN == 1)
+extern const cliTrieNode_t cliTrie[];
+extern const uint16_t cliTrieMenuRoot[];
+extern const uint16_t cliTrieMenuCount;
+#endif
  
 /**********************************************
  * PRIVATE VARIABLES
  *********************************************/
 
-static size_t len = 0;
-static char* argsStr = NULL;
-static cliElement_t* currEl = NULL;
+//Instance used by the functions that do not take a context
+static cli_ctx_t cliDefaultCtx;
 
-#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
-bool cli_cmd_waiting_treatment = false;
-#else
-static void cli_treat_command(char cliBuffer[], size_t maxLen);
-#endif //CLI_POLLING_EN
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1) && (defined(CLI_ZERO_COPY_EN) && CLI_ZERO_COPY_EN == 1)
+//Size asked by the functions without context, kept to not report a refused buffer at each character
+static size_t cliDefaultSize = 0;
+#endif
+
+#if !(defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1)
+//Root of the menus, parent of cliMainMenu
+static cliElement_t const cliMainElement = cliSubMenuElement("main", cliMainMenu, "main menu");
+#endif
+
+//Context whose command is being executed (target of the argument getters)
+static CLI_THREAD_LOCAL cli_ctx_t* cliCurrCtx = NULL;
+
+#if !(defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+//Called by cli_ctx_insert_char once a line is complete, not part of the API in this mode
+static void cli_ctx_treat_command(cli_ctx_t* ctx);
+#endif
+
+#if (defined(CLI_MENU_PRINT_ENABLE) && CLI_MENU_PRINT_ENABLE == 1)
+//Writes the prebuilt help without formatting it, defined with the other outputs
+static void cli_ctx_write(cli_ctx_t* ctx, char const data[], size_t len);
+#endif
+
+#if (defined(CLI_STATS_EN) && CLI_STATS_EN == 1)
+//Statistics of the executed actions, in order of first execution
+static cliStats_t cliStats[CLI_STATS_MAX_ELEMENTS];
+static size_t cliStatsCount = 0;
+static uint32_t cliStatsOthers = 0;
+#endif
+
+#if (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1)
+//Registered elements sorted by name (case insensitive), as indexes in the cli_registry section
+static uint16_t cliRegistryIndex[CLI_REGISTRY_MAX_ELEMENTS];
+static uint16_t cliRegistryCount = 0;
+static volatile bool cliRegistrySorted = false;
+#endif
+
+#if (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+//Ring of the last executions, cliTraceCount is the amount of entries ever written
+static cliTrace_t cliTrace[CLI_TRACE_SIZE];
+static uint32_t cliTraceCount = 0;
+
+//Actions named by the entries, in order of first execution
+static cliElement_t const* cliTraceElements[CLI_TRACE_MAX_ELEMENTS];
+static uint16_t cliTraceElementsCount = 0;
+#endif
 
 /**********************************************
  * PRIVATE FUNCTIONS
@@ -66,28 +273,35 @@ static void cli_treat_command(char cliBuffer[], size_t maxLen);
  
 static inline bool cli_is_terminator(cliElement_t const * const e){
     if(e == NULL) return false;
+    #if (defined(CLI_COMPACT_EN) && CLI_COMPACT_EN == 1)
+    return (e->name == CLI_COMPACT_NONE);
+    #else
     return (e->name == NULL && e->action == NULL && e->args == NULL && e->desc == NULL && e->argsDesc == NULL);
+    #endif
 }
 
 static inline bool cli_is_sub_menu(cliElement_t const * const e){
     if(e == NULL) return false;
-    return (e->subMenuRef != NULL);
+    return (CLI_EL_SUB(e) != NULL);
 }
 
 static inline bool cli_is_action(cliElement_t const * const e){
     if(e == NULL) return false;
-    return (e->action != NULL);
+    return (CLI_EL_ACTION(e) != NULL);
 }
 
-static int64_t cli_verify_args_str(cliElement_t const * const e, bool* elipsisPresent){
-    if(e->args == NULL) return -1;
+static cliArgsSpec_t const* cli_get_args_spec(cli_ctx_t* ctx, cliElement_t const * const e){
+    if(e == NULL || CLI_EL_ARGS(e) == NULL) return NULL;
+    if(ctx->specEl == e) return &ctx->spec;
+    
+    char const * const args = CLI_EL_ARGS(e);
     
-    size_t len = strlen(e->args);
-    size_t argsLen = 0;
-    *elipsisPresent = 0;
+    ctx->specEl = NULL;
+    ctx->spec.count = 0;
+    ctx->spec.elipsis = false;
     
-    for(int i = 0; i < len; i++){
-        switch(e->args[i]){
+    for(size_t i = 0; args[i] != '\0'; i++){
+        switch(args[i]){
             #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
             case 'f' :
             #endif
@@ -97,46 +311,110 @@ static int64_t cli_verify_args_str(cliElement_t const * const e, bool* elipsisPr
             case 's' :
             case 'b' :
             case '*' : {
-                argsLen++;
+                if(ctx->spec.count >= CLI_MAX_ARGUMENTS){
+                    ERR_PRINTLN("Arguments string list is longer than CLI_MAX_ARGUMENTS for action '%s'", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
+                    ERR_PRINTLN("");
+                    return NULL;
+                }
+                
+                char const type = args[i];
+                uint8_t width = 64;
+                
+                //Optional width qualifier after integers (u8, i16, u32, i64)
+                if( (type == 'u' || type == 'i') && '0' <= args[i + 1] && args[i + 1] <= '9' ){
+                    width = 0;
+                    
+                    while('0' <= args[i + 1] && args[i + 1] <= '9' && width < 100) width = (uint8_t) (width * 10 + args[++i] - '0');
+                    
+                    //Always checked, whatever CLI_ARGS_CHECK_EN : cli_parse_int shifts by the width
+                    if(width != 8 && width != 16 && width != 32 && width != 64){
+                        ERR_PRINTLN("Unsupported integer width %u in argument list for action '%s'", width, ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
+                        ERR_PRINTLN("");
+                        return NULL;
+                    }
+                }
+                
+                ctx->spec.types[ctx->spec.count] = type;
+                ctx->spec.widths[ctx->spec.count++] = width;
                 break;
             }
             
             case '.' : {
-                if(len < i + 2 || e->args[i + 1] != '.' || e->args[i + 2] != '.'){
-                    ERR_PRINTLN("Arguments string list contains incomplete elipsis for action '%s'", ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
+                #if (defined(CLI_ARGS_CHECK_EN) && CLI_ARGS_CHECK_EN == 1)
+                if(args[i + 1] != '.' || args[i + 2] != '.'){
+                    ERR_PRINTLN("Arguments string list contains incomplete elipsis for action '%s'", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
                     ERR_PRINTLN("");
-                    return -1;
+                    return NULL;
                 }
                 
-                DBG_PRINTLN("%d, %d", len, i);
-                
-                if(len > i + 3){
-                    ERR_PRINTLN("Arguments string list contains arguments after elipsis for action '%s'", ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
+                if(args[i + 3] != '\0'){
+                    ERR_PRINTLN("Arguments string list contains arguments after elipsis for action '%s'", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
                     ERR_PRINTLN("");
-                    return -1;
+                    return NULL;
                 }
+                #endif
                 
-                *elipsisPresent = 1;
-                return argsLen++;
+                ctx->spec.elipsis = true;
+                ctx->specEl = e;
+                return &ctx->spec;
             }
             
             default : {
-                ERR_PRINTLN("Unrecognized character in argument list index %d for action '%s'", i, ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
+                #if (defined(CLI_ARGS_CHECK_EN) && CLI_ARGS_CHECK_EN == 1)
+                ERR_PRINTLN("Unrecognized character in argument list index %u for action '%s'", (unsigned) i, ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
                 ERR_PRINTLN("");
-                return -1;
+                return NULL;
+                #else
+                break;
+                #endif
             }
         }
     }
     
-    return argsLen;
+    ctx->specEl = e;
+    return &ctx->spec;
+}
+
+#if (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1)
+//strcmp, case insensitive
+static int cli_registry_cmp(char const a[], char const b[]){
+    size_t i = 0;
+    
+    while(a[i] != '\0' && tolower(a[i]) == tolower(b[i])) i++;
+    
+    return tolower(a[i]) - tolower(b[i]);
+}
+
+static void cli_registry_sort(void){
+    if(cliRegistrySorted) return;
+    
+    size_t const total = ( (__start_cli_registry == NULL) ? 0 : (size_t) (__stop_cli_registry - __start_cli_registry) );
+    
+    cliRegistryCount = 0;
+    
+    //Insertion sort, done once on a few tens of names
+    for(size_t i = 0; i < total && cliRegistryCount < CLI_REGISTRY_MAX_ELEMENTS; i++){
+        char const * const name = __start_cli_registry[i].name;
+        
+        if(name == NULL) continue;
+        
+        size_t k = cliRegistryCount++;
+        
+        for(; k > 0 && cli_registry_cmp(__start_cli_registry[cliRegistryIndex[k - 1]].name, name) > 0; k--) cliRegistryIndex[k] = cliRegistryIndex[k - 1];
+        
+        cliRegistryIndex[k] = (uint16_t) i;
+    }
+    
+    cliRegistrySorted = true;
 }
+#endif
 
-static void cli_print_element(cliElement_t const * const e){
+static void cli_print_element(cli_ctx_t* ctx, cliElement_t const * const e){
     if(e == NULL) return;
     
     bool const is_sub_menu = cli_is_sub_menu(e);
 
-    char const * const name = ( (e->name == NULL) ? "NULL_NAME" : e->name );
+    char const * const name = ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) );
     
     MENU_PRINTF("   %s%s", name, ( (is_sub_menu == true) ? "... " : " " ) );
 
@@ -146,78 +424,85 @@ static void cli_print_element(cliElement_t const * const e){
 
     spaces -= len;
 
-    for(uint32_t i = 0; i < spaces; i++) MENU_PRINTF(" ");
+    MENU_PRINTF("%*s", (int) spaces, "");
     
-    MENU_PRINTLN("- %s", ( (e->desc == NULL) ? "NULL_DESC" : e->desc) );
+    MENU_PRINTLN("- %s", ( (CLI_EL_DESC(e) == NULL) ? "NULL_DESC" : CLI_EL_DESC(e)) );
 } 
 
-static void cli_print_menu(cliElement_t const * const e){
+static void cli_print_menu(cli_ctx_t* ctx, cliElement_t const * const e){
     if(e == NULL) return;
-    if(e->subMenuRef == NULL){
-        ERR_PRINTLN("Reference of menu '%s' is NULL", ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
+    if(CLI_EL_SUB(e) == NULL){
+        ERR_PRINTLN("Reference of menu '%s' is NULL", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
         return;  
     } 
 
-    for(uint8_t i = 0; !cli_is_terminator(&e->subMenuRef[i]); i++)
-        cli_print_element(&e->subMenuRef[i]);
+    for(uint8_t i = 0; !cli_is_terminator(&CLI_EL_SUB(e)[i]); i++)
+        cli_print_element(ctx, &CLI_EL_SUB(e)[i]);
+    
+    #if (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1)
+    if(e == CLI_MAIN_ELEMENT){
+        cli_registry_sort();
+        
+        for(size_t i = 0; i < cliRegistryCount; i++) cli_print_element(ctx, &__start_cli_registry[cliRegistryIndex[i]]);
+    }
+    #endif
         
     MENU_PRINTLN("");
 }
 
-static void cli_print_action(cliElement_t const * const e){
+static void cli_print_action(cli_ctx_t* ctx, cliElement_t const * const e){
     if(e == NULL) return;
-    if(e->args == NULL) {
-        ERR_PRINTLN("Action of element '%s' is NULL", ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
+    if(CLI_EL_ARGS(e) == NULL) {
+        ERR_PRINTLN("Action of element '%s' is NULL", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
         return;
     }
     
-    MENU_PRINTLN("Action '%s' - %s - usage :", ( (e->name == NULL) ? "NULL_NAME" : e->name), ( (e->desc == NULL) ? "NULL_DESC" : e->desc ) );
+    MENU_PRINTLN("Action '%s' - %s - usage :", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e)), ( (CLI_EL_DESC(e) == NULL) ? "NULL_DESC" : CLI_EL_DESC(e) ) );
     
-    bool elipsisPresent = 0;
-    int64_t len = cli_verify_args_str(e, &elipsisPresent);
+    cliArgsSpec_t const * const argsSpec = cli_get_args_spec(ctx, e);
     
-    if(len == -1){
+    if(argsSpec == NULL){
         return;
     }
     
-    if(len == 0){
+    if(argsSpec->count == 0 && !argsSpec->elipsis){
         MENU_PRINTLN("   No arguments");
         return;
     }
     
-    bool argsDescEnded = (e->argsDesc == NULL || e->argsDesc[0] == NULL);
+    bool argsDescEnded = (CLI_EL_ARGS_DESC(e) == NULL || CLI_EL_ARGS_DESC(e)[0] == NULL);
     
     int i = 0;
-    for(i = 0; i < len; i++){
-        switch(e->args[i]){
+    for(i = 0; i < argsSpec->count; i++){
+        switch(argsSpec->types[i]){
             #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
             case 'f' : MENU_PRINTF("   < float   > - "); break;
             #endif
 
-            case 'u' : MENU_PRINTF("   < uint64  > - "); break;
-            case 'i' : MENU_PRINTF("   < int64   > - "); break;
+            case 'u' : MENU_PRINTF("   < uint%-4u> - ", argsSpec->widths[i]); break;
+            case 'i' : MENU_PRINTF("   < int%-5u> - ", argsSpec->widths[i]); break;
             case 's' : MENU_PRINTF("   < string  > - "); break;
             case 'b' : MENU_PRINTF("   < buffer  > - "); break;
             case '*' : MENU_PRINTF("   < any     > - "); break;
             default  : MENU_PRINTF("   < unknown > - "); break;
         }
         
-        argsDescEnded = (argsDescEnded == true || e->argsDesc == NULL || e->argsDesc[i] == NULL);
+        argsDescEnded = (argsDescEnded == true || CLI_EL_ARGS_DESC(e) == NULL || CLI_EL_ARGS_DESC(e)[i] == NULL);
         
         if(argsDescEnded){
             MENU_PRINTLN("");
             continue;
         }
         
-        MENU_PRINTLN("%s", e->argsDesc[i]);   
+        MENU_PRINTLN("%s", CLI_EL_ARGS_DESC(e)[i]);   
     }
     
-    if(elipsisPresent){
+    if(argsSpec->elipsis){
         MENU_PRINTF("   < various > - ");
         
-        argsDescEnded = (argsDescEnded == true || e->argsDesc == NULL || e->argsDesc[i] == NULL);
+        argsDescEnded = (argsDescEnded == true || CLI_EL_ARGS_DESC(e) == NULL || CLI_EL_ARGS_DESC(e)[i] == NULL);
 
-        if(!argsDescEnded) MENU_PRINTLN("%s", e->argsDesc[i]);
+        if(!argsDescEnded) MENU_PRINTLN("%s", CLI_EL_ARGS_DESC(e)[i]);
 
         MENU_PRINTLN("");
     }
@@ -225,6 +510,7 @@ static void cli_print_action(cliElement_t const * const e){
     MENU_PRINTLN("");
 }
 
+#if !(defined(CLI_TRIE_EN) && CLI_TRIE_EN == 1)
 static bool cli_str_starts_with(char const tkn[], char const str[]){
     if(tkn == NULL || str == NULL) return false;
     
@@ -241,32 +527,124 @@ static bool cli_str_starts_with(char const tkn[], char const str[]){
     return true;
 }
 
-static cliElement_t* cli_find_element_in_menu(char* tkn, char cliBuffer[], size_t maxLen, cliElement_t currentMenu[]){
+#if (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1)
+//Registered element selected by tkn, NULL if none. The names starting with tkn follow each other in the index, from the first name
+//not lower than tkn, so only that one and the next one have to be compared
+static cliElement_t* cli_registry_find(char const tkn[], bool* unique){
+    cli_registry_sort();
+    
+    size_t lo = 0;
+    size_t hi = cliRegistryCount;
+    
+    while(lo < hi){
+        size_t const mid = lo + (hi - lo) / 2;
+        
+        if(cli_registry_cmp(__start_cli_registry[cliRegistryIndex[mid]].name, tkn) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    
+    *unique = true;
+    
+    if(lo >= cliRegistryCount || !cli_str_starts_with(tkn, __start_cli_registry[cliRegistryIndex[lo]].name)) return NULL;
+    
+    *unique = ( lo + 1 >= cliRegistryCount || !cli_str_starts_with(tkn, __start_cli_registry[cliRegistryIndex[lo + 1]].name) );
+    
+    return (cliElement_t*) &__start_cli_registry[cliRegistryIndex[lo]];
+}
+#endif
+
+static cliElement_t* cli_find_element_in_menu(cli_ctx_t* ctx, char* tkn, cliElement_t currentMenu[]){
     if(tkn == NULL) return NULL;
-    if(maxLen == 0) return NULL;
-    if(cliBuffer == NULL) return NULL;
     if(currentMenu == NULL) return NULL;
-    if(currentMenu->subMenuRef == NULL) return NULL;
+    if(CLI_EL_SUB(currentMenu) == NULL) return NULL;
     
     cliElement_t* ret = NULL;
     
-    for(uint8_t i = 0; !cli_is_terminator(&currentMenu->subMenuRef[i]); i++){
-        if(currentMenu->subMenuRef[i].name == NULL) continue;
+    for(uint8_t i = 0; !cli_is_terminator(&CLI_EL_SUB(currentMenu)[i]); i++){
+        if(CLI_EL_NAME(&CLI_EL_SUB(currentMenu)[i]) == NULL) continue;
         
-        if(!cli_str_starts_with(tkn, currentMenu->subMenuRef[i].name)) continue;
+        if(!cli_str_starts_with(tkn, CLI_EL_NAME(&CLI_EL_SUB(currentMenu)[i]))) continue;
         
         if(ret != NULL){
             ERR_PRINTLN("Command not unique");
             return NULL;
         } 
         
-        ret = (cliElement_t*) &currentMenu->subMenuRef[i];
+        ret = (cliElement_t*) &CLI_EL_SUB(currentMenu)[i];
+    }
+    
+    #if (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1)
+    if(currentMenu == CLI_MAIN_ELEMENT){
+        bool unique = true;
+        cliElement_t* const reg = cli_registry_find(tkn, &unique);
+        
+        if(!unique || (reg != NULL && ret != NULL)){
+            ERR_PRINTLN("Command not unique");
+            return NULL;
+        }
+        
+        if(reg != NULL) ret = reg;
     }
+    #endif
     
     DBG_PRINTLN("%s", ret == NULL ? "Not found" : "Sub menu or action found" );
     
     return ret;
 }
+#endif
+
+#if (defined(CLI_TRIE_EN) && CLI_TRIE_EN == 1)
+static cliElement_t* cli_find_element_in_trie(cli_ctx_t* ctx, char* tkn, cliElement_t currentMenu[], uint16_t* menuIdx){
+    if(tkn == NULL) return NULL;
+    if(currentMenu == NULL) return NULL;
+    if(CLI_EL_SUB(currentMenu) == NULL) return NULL;
+    
+    if(*menuIdx >= cliTrieMenuCount){
+        ERR_PRINTLN("Menu '%s' is not in the trie, regenerate it", ( (CLI_EL_NAME(currentMenu) == NULL) ? "NULL_NAME" : CLI_EL_NAME(currentMenu) ) );
+        return NULL;
+    }
+    
+    cliTrieNode_t const* node = &cliTrie[cliTrieMenuRoot[*menuIdx]];
+    
+    for(size_t i = 0; node->element == CLI_TRIE_AMBIGUOUS; i++){
+        if(tkn[i] == '\0'){
+            ERR_PRINTLN("Command not unique");
+            return NULL;
+        }
+        
+        char const c = (char) tolower(tkn[i]);
+        uint16_t child = node->next;
+        
+        while(child != CLI_TRIE_NONE && cliTrie[child].c != c) child = cliTrie[child].sibling;
+        
+        if(child == CLI_TRIE_NONE){
+            DBG_PRINTLN("Not found");
+            return NULL;
+        }
+        
+        node = &cliTrie[child];
+    }
+    
+    cliElement_t* ret = (cliElement_t*) &CLI_EL_SUB(currentMenu)[node->element];
+    
+    //Only one candidate left, the whole token must still be a prefix of its name
+    char const * const name = CLI_EL_NAME(ret);
+    
+    if(name == NULL) return NULL;
+    
+    for(size_t i = 0; tkn[i] != '\0'; i++){
+        if(name[i] == '\0' || tolower(tkn[i]) != tolower(name[i])){
+            DBG_PRINTLN("Not found");
+            return NULL;
+        }
+    }
+    
+    DBG_PRINTLN("Sub menu or action found");
+    
+    *menuIdx = node->next;
+    return ret;
+}
+#endif
 
 static int32_t cli_arg_str_len(char* arg){
     if(arg ==  NULL) return -1;
@@ -319,7 +697,7 @@ static char* cli_go_to_next_argument(char* arg){
     return arg;
 }
 
-static void cli_print_arg(char* s){
+static void cli_print_arg(cli_ctx_t* ctx, char* s){
 #if (defined(CLI_DEBUG_ENABLE) && CLI_DEBUG_ENABLE == 1)
     int len = cli_arg_str_len(s);
     DBG_PRINTF("Argument size %d = ", len);
@@ -329,7 +707,7 @@ static void cli_print_arg(char* s){
 }
 
 #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
-static bool cli_verify_float(char* tkn, bool printEn){
+static bool cli_verify_float(cli_ctx_t* ctx, char* tkn, bool printEn){
     int32_t len = cli_arg_str_len(tkn);
 
     int32_t i = 0;
@@ -365,9 +743,86 @@ static bool cli_verify_float(char* tkn, bool printEn){
 }
 #endif
 
-static bool cli_verify_int(char* tkn, bool isUnsigned, bool printEn){
-    int32_t len = cli_arg_str_len(tkn);
-    bool is_negative = false;
+//Value of an hex digit (0 - 15), 0xFF if the character is not one
+static inline uint8_t cli_digit_value(char c){
+    uint8_t d = (uint8_t) (c - '0');
+    
+    if(d <= 9) return d;
+    
+    d = (uint8_t) ( (c | 0x20) - 'a' );
+    
+    return ( (d <= 5) ? d + 10 : 0xFF );
+}
+
+//Validates and accumulates the digits of tkn[i..len[ as decimal and hex in parallel, using only 32 bits arithmetic. Returns the index
+//of the first invalid character (len if there is none), inRange is false if the value is bigger than max
+static int32_t cli_accumulate_int32(char const* tkn, int32_t i, int32_t len, bool isHex, bool decOnly, uint32_t max, uint32_t* res, bool* inRange){
+    uint32_t const maxDiv10 = max / 10;
+    uint32_t const maxMod10 = max % 10;
+    uint32_t dec = 0;
+    uint32_t hex = 0;
+    bool decOverflow = false;
+    bool hexOverflow = false;
+    
+    for(; i < len; i++){
+        uint8_t const d = cli_digit_value(tkn[i]);
+        
+        if(d == 0xFF || (d > 9 && decOnly)) return i;
+        
+        isHex |= (d > 9);
+        
+        if(dec > maxDiv10 || (dec == maxDiv10 && d > maxMod10)) decOverflow = true;
+        if(hex > (max >> 4)) hexOverflow = true;
+        
+        dec = dec * 10 + d;
+        hex = (hex << 4) | d;
+        
+        if(hex > max) hexOverflow = true;
+    }
+    
+    *res = ( (isHex) ? hex : dec );
+    *inRange = ( (isHex) ? !hexOverflow : !decOverflow );
+    
+    return len;
+}
+
+//Same as cli_accumulate_int32 for 64 bits arguments
+static int32_t cli_accumulate_int64(char const* tkn, int32_t i, int32_t len, bool isHex, bool decOnly, uint64_t max, uint64_t* res, bool* inRange){
+    uint64_t const maxDiv10 = max / 10;
+    uint64_t const maxMod10 = max % 10;
+    uint64_t dec = 0;
+    uint64_t hex = 0;
+    bool decOverflow = false;
+    bool hexOverflow = false;
+    
+    for(; i < len; i++){
+        uint8_t const d = cli_digit_value(tkn[i]);
+        
+        if(d == 0xFF || (d > 9 && decOnly)) return i;
+        
+        isHex |= (d > 9);
+        
+        if(dec > maxDiv10 || (dec == maxDiv10 && d > maxMod10)) decOverflow = true;
+        if(hex > (max >> 4)) hexOverflow = true;
+        
+        dec = dec * 10 + d;
+        hex = (hex << 4) | d;
+        
+        if(hex > max) hexOverflow = true;
+    }
+    
+    *res = ( (isHex) ? hex : dec );
+    *inRange = ( (isHex) ? !hexOverflow : !decOverflow );
+    
+    return len;
+}
+
+//Parses an integer argument of size len that must fit in 'width' bits (8, 16, 32 or 64). The number is hex if it begins with 0x
+//or contains a letter between a and f, decimal otherwise. The token is validated and accumulated in a single pass, with native
+//arithmetic for widths up to 32 bits. Signed results are written in two's complement
+static bool cli_parse_int(cli_ctx_t* ctx, char const* tkn, int32_t len, bool isUnsigned, uint8_t width, uint64_t* res, bool printEn){
+    bool isNegative = false;
+    bool isHex = false;
     int32_t i = 0;
 
     if(isUnsigned == false && tkn[0] == '-'){
@@ -375,33 +830,76 @@ static bool cli_verify_int(char* tkn, bool isUnsigned, bool printEn){
             if(printEn) ERR_PRINTLN("Negative int does not begin");
             return false;
         }
-        is_negative = true;
+        isNegative = true;
         i++;
     }
+    else if(len > 2 && tkn[0] == '0' && (tkn[1] | 0x20) == 'x'){
+        isHex = true;
+        i += 2;
+    }
     
-    while(i < len){
-        if( tolower(tkn[i]) == 'x' && ( tkn[i-1] != '0' || (tkn[i-2] != ' ' && tkn[i-2] != '\0') || ! ( ( '0' <= tkn[i+1] && tkn[i+1] <= '9' ) || ('a' <= tolower(tkn[i+1]) && tolower(tkn[i+1]) <= 'f') ) ) ){
-            if(printEn) ERR_PRINTLN("Incorrect Hex format in %s int argument", ( (isUnsigned == true) ? "unsigned" : "signed" ));
-            return false;
-        }
-        
-        if( !( ( ( '0' <= tkn[i] && tkn[i] <= '9' ) ) || ( is_negative == false && ( ('a' <= tolower(tkn[i]) && tolower(tkn[i]) <= 'f') || tolower(tkn[i]) == 'x') ) ) ) {
-            if(printEn) ERR_PRINTLN("Invalid character in %s int argument", ( (isUnsigned == true) ? "unsigned" : "signed" ) );
-            return false;
-        }
-
-        i++;
-    }  
+    //Biggest magnitude accepted, 2^(width - 1) for negative numbers
+    uint64_t const max = ( (isUnsigned) ? (UINT64_MAX >> (64 - width)) : ( (UINT64_MAX >> (65 - width)) + isNegative ) );
+    uint64_t num = 0;
+    bool inRange = false;
+    
+    if(width <= 32){
+        uint32_t num32 = 0;
+        i = cli_accumulate_int32(tkn, i, len, isHex, isNegative, (uint32_t) max, &num32, &inRange);
+        num = num32;
+    }
+    else{
+        i = cli_accumulate_int64(tkn, i, len, isHex, isNegative, max, &num, &inRange);
+    }
+    
+    if(i < len){
+        if(printEn && (tkn[i] | 0x20) == 'x') ERR_PRINTLN("Incorrect Hex format in %s int argument", ( (isUnsigned == true) ? "unsigned" : "signed" ));
+        else if(printEn) ERR_PRINTLN("Invalid character in %s int argument", ( (isUnsigned == true) ? "unsigned" : "signed" ) );
+        return false;
+    }
+    
+    if(!inRange){
+        if(printEn) ERR_PRINTLN("Value out of range in %s int%u argument", ( (isUnsigned == true) ? "unsigned" : "signed" ), width );
+        return false;
+    }
+    
+    *res = ( (isNegative) ? 0 - num : num );
     
     return true;
 }
 
-static bool cli_verify_buffer(char* tkn, bool printEn){
+//Value of a base64 character (0 - 63), 0xFF if the character is not one
+static inline uint8_t cli_base64_value(char c){
+    if('A' <= c && c <= 'Z') return (uint8_t) (c - 'A');
+    if('a' <= c && c <= 'z') return (uint8_t) (c - 'a' + 26);
+    if('0' <= c && c <= '9') return (uint8_t) (c - '0' + 52);
+    if(c == '+') return 62;
+    if(c == '/') return 63;
+    return 0xFF;
+}
+
+//Amount of base64 characters in a '$' buffer of size len, padding excluded. -1 if the buffer is not valid base64
+static int32_t cli_base64_length(char const* tkn, int32_t len){
+    int32_t n = len - 1;
+    
+    if(n > 0 && tkn[n] == '=') n--;
+    if(n > 0 && tkn[n] == '=') n--;
+    
+    if( (n % 4) == 1 || (n != len - 1 && ( (len - 1) % 4 ) != 0) ) return -1;
+    
+    for(int32_t i = 1; i <= n; i++){
+        if(cli_base64_value(tkn[i]) == 0xFF) return -1;
+    }
+    
+    return n;
+}
+
+static bool cli_verify_buffer(cli_ctx_t* ctx, char* tkn, bool printEn){
     int i = 0;
     
     if(tkn == NULL) return false;
-    if(tkn[0] != '"' && tkn[0] != '{') {
-        if(printEn) ERR_PRINTLN("Buffer argument does not begin with '\"' nor '{'");
+    if(tkn[0] != '"' && tkn[0] != '{' && tkn[0] != '#' && tkn[0] != '$') {
+        if(printEn) ERR_PRINTLN("Buffer argument does not begin with '\"', '{', '#' nor '$'");
         return false;
     }
     
@@ -414,6 +912,31 @@ static bool cli_verify_buffer(char* tkn, bool printEn){
     
     if(tkn[0] == '"') return true;
     
+    if(tkn[0] == '#'){
+        if( (len - 1) % 2 != 0 ){
+            if(printEn) ERR_PRINTLN("Odd amount of digits in buffer beginning with '#'");
+            return false;
+        }
+        
+        for(i = 1; i < len; i++){
+            if(cli_digit_value(tkn[i]) == 0xFF){
+                if(printEn) ERR_PRINTLN("Invalid character in buffer beginning with '#'");
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    if(tkn[0] == '$'){
+        if(cli_base64_length(tkn, len) == -1){
+            if(printEn) ERR_PRINTLN("Invalid base64 in buffer beginning with '$'");
+            return false;
+        }
+        
+        return true;
+    }
+    
     for(i = 1; i < len; i++){
         if(tkn[i] == '}') break; 
         
@@ -433,109 +956,140 @@ static bool cli_verify_buffer(char* tkn, bool printEn){
     return true;
 }
 
-static bool cli_verify_arguments(cliElement_t* e){
-    if(e == NULL) return false;
-    if(e->args == NULL) {
-        ERR_PRINTLN("Arguments string is null for action '%s'", ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
-        return false;
+static cliArgIndex_t* cli_index_argument(cli_ctx_t* ctx, char* tkn, size_t i){
+    if(i >= CLI_MAX_ARGUMENTS){
+        ERR_PRINTLN("Too many arguments, maximum is %u (see CLI_MAX_ARGUMENTS)", (unsigned) CLI_MAX_ARGUMENTS);
+        return NULL;
     }
     
-    DBG_PRINTLN("args = %s", argsStr);
-    
-    char* argTkn = argsStr;
+    ctx->args[i].start = (uint16_t) (tkn - ctx->argsStr);
+    ctx->args[i].len   = (uint16_t) cli_arg_str_len(tkn);
+    ctx->args[i].kind  = 0;
+    ctx->args[i].val.u = 0;
+    ctx->argsCount = i + 1;
     
-    bool elipsisPresent = 0;
-    int64_t len = cli_verify_args_str(e, &elipsisPresent);
+    return &ctx->args[i];
+}
+
+static uint8_t cli_classify_argument(cli_ctx_t* ctx, char* tkn, cliArgIndex_t* arg){
+    if(tkn[0] == '{' || tkn[0] == '"' || tkn[0] == '#' || tkn[0] == '$'){
+        arg->kind = ( (cli_verify_buffer(ctx, tkn, false) == true) ? CLI_ARG_KIND_BUFFER : 0 );
+        return arg->kind;
+    }
     
-    DBG_PRINTLN("Len = %d, elipsisPresent = %d", len, elipsisPresent);
+    if(cli_parse_int(ctx, tkn, arg->len, (tkn[0] != '-'), 64, &arg->val.u, false)){
+        if(tkn[0] == '-') arg->kind = CLI_ARG_KIND_INT;
+        else arg->kind = CLI_ARG_KIND_UINT | ( (arg->val.u <= INT64_MAX) ? CLI_ARG_KIND_INT : 0 );
+    }
     
-    if(len == -1){
-        return false;
+    #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
+    if(cli_verify_float(ctx, tkn, false)){
+        if(arg->kind == 0) arg->val.f = strtof(tkn, NULL);
+        arg->kind |= CLI_ARG_KIND_FLOAT;
     }
+    #endif
     
-    size_t i = 0;
+    return arg->kind;
+}
+
+//Indexes and verifies the argument number i, starting at argTkn, against its type (any type for the arguments of the ellipsis)
+static bool cli_verify_argument(cli_ctx_t* ctx, cliElement_t const * const e, cliArgsSpec_t const * const argsSpec, char* argTkn, size_t i){
+    cli_print_arg(ctx, argTkn);
     
-    for(i = 0; i < len; i++){
-        if(argTkn == NULL) {
-            ERR_PRINTLN("No arguments in argument list for action '%s'", ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
-            return false;
+    cliArgIndex_t* arg = cli_index_argument(ctx, argTkn, i);
+    
+    if(arg == NULL) return false;
+    
+    char const type = ( (i < argsSpec->count) ? argsSpec->types[i] : '*' );
+
+    switch(type){
+        
+        #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
+        case 'f' : {
+            arg->kind = CLI_ARG_KIND_FLOAT;
+            if(cli_verify_float(ctx, argTkn, true)){
+                arg->val.f = strtof(argTkn, NULL);
+                return true;
+            }
+            break;
         }
+        #endif
         
-        if(argTkn[0] == '\0'){
-            ERR_PRINTLN("Expected more arguments for action '%s'", ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
-            return false;
+        case 'i' : {
+            arg->kind = CLI_ARG_KIND_INT;
+            if(cli_parse_int(ctx, argTkn, arg->len, false, argsSpec->widths[i], &arg->val.u, true)) return true;
+            break;
+        }
+        
+        case 'u' : {
+            arg->kind = CLI_ARG_KIND_UINT;
+            if(cli_parse_int(ctx, argTkn, arg->len, true, argsSpec->widths[i], &arg->val.u, true)) return true;
+            break;
+        }
+        
+        case 's' :
+        case 'b' : {
+            arg->kind = CLI_ARG_KIND_BUFFER;
+            if(cli_verify_buffer(ctx, argTkn, true)) return true;
+            break;
+        }
+        
+        case '*' : {
+            if(cli_classify_argument(ctx, argTkn, arg) != 0) return true;
+            break;
         }
         
-        cli_print_arg(argTkn);
+        default : {
+            DBG_PRINTLN("Unrecognized arguments");
+            break;
+        }
+    }
+    
+    ERR_PRINTLN("Error occured in argument %d in action '%s'", i, ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
+    return false;
+}
 
-        switch(e->args[i]){
-            
-            #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
-            case 'f' : {
-                if(cli_verify_float(argTkn, true)) break;
-                ERR_PRINTLN("Error occured in argument %d in action '%s'", i, ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
-                return false;
-            }
-            #endif
-            
-            case 'i' : {
-                if(cli_verify_int(argTkn, false, true)) break;
-                ERR_PRINTLN("Error occured in argument %d in action '%s'", i, ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
-                return false;
-            }
-            
-            case 'u' : {
-                if(cli_verify_int(argTkn, true, true)) break;
-                ERR_PRINTLN("Error occured in argument %d in action '%s'", i, ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
-                return false;
-            }
-            
-            case 's' :
-            case 'b' : {
-                if(cli_verify_buffer(argTkn, true)) break;
-                ERR_PRINTLN("Error occured in argument %d in action '%s'", i, ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
-                return false;
-            }
-            
-            case '*' : {
-                if(cli_verify_int(argTkn, false, false) || cli_verify_buffer(argTkn, false)
-                
-                    #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
-                    || cli_verify_float(argTkn, false)
-                    #endif
-                
-                    ) 
-                {
-                    break;
-                }
-                
-                ERR_PRINTLN("Error occured in argument %d in action '%s'", i, ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
-                return false;
-            }
-            
-            default : {
-                DBG_PRINTLN("Unrecognized arguments");
-                ERR_PRINTLN("Error occured in argument %d in action '%s'", i, ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
-                return false;
-            }
+static bool cli_verify_arguments(cli_ctx_t* ctx, cliElement_t* e){
+    if(e == NULL) return false;
+    if(CLI_EL_ARGS(e) == NULL) {
+        ERR_PRINTLN("Arguments string is null for action '%s'", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
+        return false;
+    }
+    
+    DBG_PRINTLN("args = %s", ctx->argsStr);
+    
+    char* argTkn = ctx->argsStr;
+    ctx->argsCount = 0;
+    
+    cliArgsSpec_t const * const argsSpec = cli_get_args_spec(ctx, e);
+    
+    if(argsSpec == NULL){
+        return false;
+    }
+    
+    DBG_PRINTLN("Len = %d, elipsisPresent = %d", argsSpec->count, argsSpec->elipsis);
+    
+    size_t i = 0;
+    
+    for(i = 0; i < argsSpec->count; i++){
+        if(argTkn == NULL) {
+            ERR_PRINTLN("No arguments in argument list for action '%s'", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
+            return false;
+        }
+        
+        if(argTkn[0] == '\0'){
+            ERR_PRINTLN("Expected more arguments for action '%s'", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
+            return false;
         }
         
+        if(!cli_verify_argument(ctx, e, argsSpec, argTkn, i)) return false;
+        
         argTkn = cli_go_to_next_argument(argTkn);
     }
     
-    if(elipsisPresent){
+    if(argsSpec->elipsis){
         while(argTkn != NULL && argTkn[0] != '\0'){
-            if( !(cli_verify_int(argTkn, false, false) || cli_verify_buffer(argTkn, false) 
-            
-                #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
-                || cli_verify_float(argTkn, false)
-                #endif
-            
-                ) ) 
-            {
-                ERR_PRINTLN("Error occured in argument %d in action '%s'", i, ( (e->name == NULL) ? "NULL_NAME" : e->name ));
-                return false;
-            }
+            if(!cli_verify_argument(ctx, e, argsSpec, argTkn, i)) return false;
             
             argTkn = cli_go_to_next_argument(argTkn);
             i++;
@@ -544,7 +1098,7 @@ static bool cli_verify_arguments(cliElement_t* e){
     
     else {
         if(argTkn != NULL && argTkn[0] != '\0'){
-            ERR_PRINTLN("Expected less arguments for action '%s'", ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
+            ERR_PRINTLN("Expected less arguments for action '%s'", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
             return false;
         }
     }
@@ -554,81 +1108,272 @@ static bool cli_verify_arguments(cliElement_t* e){
     //return ( (argTkn[0] == '\0') ? true : false );
 }
 
-static void cli_execute_action(cliElement_t* e){
-    if(e == NULL) return;
-    if(e->args == NULL) {
-        ERR_PRINTLN("Argument list NULL in action '%s'", ( (e->name == NULL) ? "NULL_NAME" : e->name ) );
-        return;
+#if (defined(CLI_STATS_EN) && CLI_STATS_EN == 1)
+static void cli_stats_add(cliStatsTime_t* t, uint32_t time, bool first){
+    if(first || time < t->min) t->min = time;
+    if(first || time > t->max) t->max = time;
+    
+    t->sum += time;
+}
+
+//The table is shared by all instances, the search and the update are done under CLI_LOCK
+static void cli_stats_record(cliElement_t const * const e, uint32_t parse, uint32_t exec){
+    size_t i = 0;
+    
+    CLI_LOCK();
+    
+    while(i < cliStatsCount && cliStats[i].el != e) i++;
+    
+    if(i == cliStatsCount && cliStatsCount < CLI_STATS_MAX_ELEMENTS){
+        memset(&cliStats[i], 0, sizeof(cliStats_t));
+        cliStats[i].el = e;
+        cliStatsCount++;
     }
     
-    do{
-        bool elipsisPresent = false;
-        int64_t len = cli_verify_args_str(e, &elipsisPresent);
+    if(i < cliStatsCount){
+        cliStats_t* const s = &cliStats[i];
         
-        if(len == -1) return;
+        cli_stats_add(&s->parse, parse, s->count == 0);
+        cli_stats_add(&s->exec, exec, s->count == 0);
+        s->count++;
+    }
+    else{
+        cliStatsOthers++;
+    }
+    
+    CLI_UNLOCK();
+}
+#endif
 
-        argsStr = strtok(NULL, "\0");
-        
-        if(argsStr == NULL) argsStr = "";
+#if (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+//Called under CLI_LOCK, the table is shared by all instances
+static uint16_t cli_trace_id(cliElement_t const * const e){
+    uint16_t id = 0;
+    
+    while(id < cliTraceElementsCount && cliTraceElements[id] != e) id++;
+    
+    if(id == cliTraceElementsCount){
+        if(cliTraceElementsCount >= CLI_TRACE_MAX_ELEMENTS) return CLI_TRACE_NO_ID;
         
-        if(argsStr == NULL && len != 0) { ERR_PRINTLN("No arguments in list"); break; }
+        cliTraceElements[cliTraceElementsCount++] = e;
+    }
+    
+    return id;
+}
+
+//The slot is reserved and written under CLI_LOCK, two instances never share it
+static void cli_trace_record(cli_ctx_t* ctx, cliElement_t const * const e, bool verified, uint32_t parsed, uint32_t executed){
+    CLI_LOCK();
+    
+    cliTrace_t* const t = &cliTrace[cliTraceCount & (CLI_TRACE_SIZE - 1)];
+    
+    t->start = ctx->treatStart;
+    t->parse = parsed - ctx->treatStart;
+    t->exec  = executed - parsed;
+    t->id    = cli_trace_id(e);
+    t->flags = ( (verified) ? CLI_TRACE_VERIFIED : 0 );
+    t->args  = (uint8_t) ctx->argsCount;
+    
+    cliTraceCount++;
+    
+    CLI_UNLOCK();
+}
+#endif
+
+#if (defined(CLI_HELP_PREBUILT_EN) && CLI_HELP_PREBUILT_EN == 1)
+//Entry generated by cli_help_gen for the element e of the menu number menuIdx, NULL if the tables do not match the menu
+static cliHelpElement_t const* cli_get_help_element(uint16_t menuIdx, cliElement_t const * const menu, cliElement_t const * const e){
+    if(menuIdx >= cliHelpMenuCount) return NULL;
+    
+    size_t const i = cliHelpMenuFirst[menuIdx] + (size_t) (e - CLI_EL_SUB(menu));
+    
+    if(i >= cliHelpMenuFirst[menuIdx + 1]) return NULL;
+    
+    return &cliHelpElements[i];
+}
+#endif
+
+//Prints the usage of an action, from the text generated by cli_help_gen if there is one
+static void cli_print_usage(cli_ctx_t* ctx, cliElement_t const * const e, cliHelpElement_t const * const usage){
+    if(usage != NULL){
+        MENU_WRITE(usage->usage, usage->usageLen);
+        return;
+    }
+    
+    cli_print_action(ctx, e);
+}
+
+//Characters an argument can begin with, anything else before the first argument is skipped
+static inline bool cli_is_arg_start(char c){
+    return (c == '-' || c == '{' || c == '"' || c == '#' || c == '$' || ('0' <= c && c <= '9') || ('a' <= tolower(c) && tolower(c) <= 'f'));
+}
+
+static inline void cli_run_action(cli_ctx_t* ctx, cliElement_t const * const e){
+    #if (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+    if(e->typed != NULL){
+        if(!e->typed->trampoline(ctx, e->typed->fn)) ERR_PRINTLN("Arguments of action '%s' do not fit in its structure", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
+        return;
+    }
+    #endif
+    
+    CLI_EL_ACTION(e)();
+}
+
+//Calls an action whose arguments are verified
+static void cli_call_action(cli_ctx_t* ctx, cliElement_t* e){
+    if(CLI_EL_ACTION(e) == NULL) { 
+        ERR_PRINTLN("No action configured for action '%s'", ( (CLI_EL_NAME(e) == NULL)  ? "NULL_NAME" : CLI_EL_NAME(e) ) );
+        ERR_PRINTLN("");
+        ctx->argsStr = NULL;
+        return;
+    }
+    
+    cli_ctx_t* const prevCtx = cliCurrCtx;
+    
+    ctx->currEl = e;
+    cliCurrCtx = ctx;
+    
+    #if (defined(CLI_STATS_EN) && CLI_STATS_EN == 1) || (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+    uint32_t const parsed = (uint32_t) CLI_STATS_TIMER();
+    
+    cli_run_action(ctx, e);
+    
+    uint32_t const executed = (uint32_t) CLI_STATS_TIMER();
+    
+    #if (defined(CLI_STATS_EN) && CLI_STATS_EN == 1)
+    cli_stats_record(e, parsed - ctx->treatStart, executed - parsed);
+    #endif
+    
+    #if (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+    cli_trace_record(ctx, e, true, parsed, executed);
+    #endif
+    #else
+    cli_run_action(ctx, e);
+    #endif
+    
+    cliCurrCtx = prevCtx;
+    ctx->currEl = NULL;
+    ctx->argsStr = NULL;
+    ctx->argsCount = 0;
+}
+
+static void cli_execute_action(cli_ctx_t* ctx, cliElement_t* e, cliHelpElement_t const * const usage){
+    if(e == NULL) return;
+    if(CLI_EL_ARGS(e) == NULL) {
+        ERR_PRINTLN("Argument list NULL in action '%s'", ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
+        return;
+    }
+    
+    do{
+        cliArgsSpec_t const * const argsSpec = cli_get_args_spec(ctx, e);
         
-        while(argsStr != NULL && argsStr[0] != '\0') {
-            if(argsStr[0] == '-' || argsStr[0] == '{' || argsStr[0] == '"' || ('0' <= argsStr[0] && argsStr[0] <= '9') || ('a' <= tolower(argsStr[0]) && tolower(argsStr[0]) <= 'f')) break;
-            argsStr++;
-        }
+        if(argsSpec == NULL) return;
         
-        if(argsStr != NULL && argsStr[0] == '\0' && len != 0) { ERR_PRINTLN("Unable to find first argument in list"); break; }
+        size_t const len = argsSpec->count;
+
+        ctx->argsStr = ( (ctx->nextTkn == NULL) ? "" : ctx->nextTkn );
         
-        if(cli_verify_arguments(e) == false) { DBG_PRINTLN("Invalid args"); break; }
+        if(ctx->argsStr == NULL && len != 0) { ERR_PRINTLN("No arguments in list"); break; }
         
-        if(e->action == NULL) { 
-            ERR_PRINTLN("No action configured for action '%s'", ( (e->name == NULL)  ? "NULL_NAME" : e->name ) );
-            ERR_PRINTLN("");
-            argsStr = NULL;
-            return;
+        while(ctx->argsStr != NULL && ctx->argsStr[0] != '\0') {
+            if(cli_is_arg_start(ctx->argsStr[0])) break;
+            ctx->argsStr++;
         }
         
-        currEl = e;
+        if(ctx->argsStr != NULL && ctx->argsStr[0] == '\0' && len != 0) { ERR_PRINTLN("Unable to find first argument in list"); break; }
         
-        e->action();
-        
-        currEl = NULL;
-        argsStr = NULL;
+        if(cli_verify_arguments(ctx, e) == false) { DBG_PRINTLN("Invalid args"); break; }
         
+        cli_call_action(ctx, e);
         return;
         
     }while(0);
     
-    argsStr = NULL;
-    MENU_PRINTLN("Invalid arguments, use 10, -10, or 0x10 for integers, 2.5 or -2.5 for float, and \"foo\" or { 0A 0B } for strings and buffers");
+    #if (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+    uint32_t const refused = (uint32_t) CLI_STATS_TIMER();
+    cli_trace_record(ctx, e, false, refused, refused);
+    #endif
+    
+    ctx->argsStr = NULL;
+    MENU_PRINTLN("Invalid arguments, use 10, -10, or 0x10 for integers, 2.5 or -2.5 for float, and \"foo\", { 0A 0B }, #0A0B or $CgsB for strings and buffers");
     MENU_PRINTLN("");
-    cli_print_action(e);
+    cli_print_usage(ctx, e, usage);
+}
+
+//Reentrant strtok(buffer, " ") : returns the next word of the command, terminated in place, and keeps the position in the context
+static char* cli_next_token(cli_ctx_t* ctx){
+    char* tkn = ctx->nextTkn;
+    
+    if(tkn == NULL) return NULL;
+    
+    while(*tkn == ' ') tkn++;
+    
+    if(*tkn == '\0'){
+        ctx->nextTkn = NULL;
+        return NULL;
+    }
+    
+    char* end = tkn;
+    
+    while(*end != ' ' && *end != '\0') end++;
+    
+    if(*end == ' ') *end++ = '\0';
+    
+    ctx->nextTkn = ( (*end == '\0') ? NULL : end );
+    
+    return tkn;
 }
 
-static void cli_find_action(char cliBuffer[], size_t maxLen){
-    if(maxLen == 0) return;
-    if(cliBuffer == NULL) return;
+static void cli_find_action(cli_ctx_t* ctx){
+    if(ctx->line == NULL) return;
+    
+    CLI_TREAT_START(ctx);
+    
+    cliElement_t* currentMenu = CLI_MAIN_ELEMENT;
     
-    cliElement_t init = cliSubMenuElement("main", cliMainMenu, "main menu");
-    cliElement_t* currentMenu = &init;
-    char* tkn = strtok((char*)cliBuffer, " ");
+    ctx->nextTkn = ctx->line;
+    
+    char* tkn = cli_next_token(ctx);
+    
+    #if (defined(CLI_TRIE_EN) && CLI_TRIE_EN == 1) || (defined(CLI_HELP_PREBUILT_EN) && CLI_HELP_PREBUILT_EN == 1)
+    uint16_t menuIdx = 0;
+    #endif
+    
+    cliHelpElement_t const* usage = NULL;
     
     while(tkn != NULL){
-        cliElement_t* e = cli_find_element_in_menu(tkn, cliBuffer, maxLen, currentMenu);
+        #if (defined(CLI_HELP_PREBUILT_EN) && CLI_HELP_PREBUILT_EN == 1)
+        uint16_t const parentIdx = menuIdx;
+        #endif
+        
+        #if (defined(CLI_TRIE_EN) && CLI_TRIE_EN == 1)
+        cliElement_t* e = cli_find_element_in_trie(ctx, tkn, currentMenu, &menuIdx);
+        #else
+        cliElement_t* e = cli_find_element_in_menu(ctx, tkn, currentMenu);
+        #endif
         
         if(e == NULL){
             break;
         }
         
+        #if (defined(CLI_HELP_PREBUILT_EN) && CLI_HELP_PREBUILT_EN == 1)
+        cliHelpElement_t const * const help = cli_get_help_element(parentIdx, currentMenu, e);
+        
+        usage = ( (help == NULL || help->usage == NULL) ? NULL : help );
+        
+        #if !(defined(CLI_TRIE_EN) && CLI_TRIE_EN == 1)
+        menuIdx = ( (help == NULL) ? CLI_HELP_NONE : help->subMenu );
+        #endif
+        #endif
+        
         if(cli_is_sub_menu(e)){
-            DBG_PRINTLN("Entering submenu '%s'", e->name);
+            DBG_PRINTLN("Entering submenu '%s'", CLI_EL_NAME(e));
             currentMenu = e;
         }
         
         else if(cli_is_action(e)){
-            DBG_PRINTLN("Action '%s' found", e->name);
-            cli_execute_action(e);
+            DBG_PRINTLN("Action '%s' found", CLI_EL_NAME(e));
+            cli_execute_action(ctx, e, usage);
             return;
         }
         
@@ -638,225 +1383,1228 @@ static void cli_find_action(char cliBuffer[], size_t maxLen){
             return;
         }
 
-        tkn = strtok(NULL, " ");
-    }
+        tkn = cli_next_token(ctx);
+    }
+    
+    #if (defined(CLI_HELP_PREBUILT_EN) && CLI_HELP_PREBUILT_EN == 1)
+    if(menuIdx < cliHelpMenuCount){
+        MENU_WRITE(cliHelpMenu[menuIdx], cliHelpMenuLen[menuIdx]);
+        return;
+    }
+    #endif
+    
+    MENU_PRINTF("Menu '%s' - %s\r\n", CLI_EL_NAME(currentMenu), CLI_EL_DESC(currentMenu));
+    cli_print_menu(ctx, currentMenu);
+}
+
+#if (defined(CLI_INCREMENTAL_EN) && CLI_INCREMENTAL_EN == 1)
+static void cli_inc_reset(cli_ctx_t* ctx){
+    ctx->incState = CLI_INC_IDLE;
+    ctx->incMenu = NULL;
+    ctx->incAction = NULL;
+    ctx->incMenuIdx = 0;
+}
+
+//Looks up the name received from incTkn to end (the space after it, or the end of the line)
+static void cli_inc_name(cli_ctx_t* ctx, size_t end){
+    cliElement_t* currentMenu = ( (ctx->incMenu == NULL) ? CLI_MAIN_ELEMENT : ctx->incMenu );
+    
+    //The line stays untouched in case it has to be parsed again
+    char const c = ctx->buffer[end];
+    ctx->buffer[end] = '\0';
+    
+    #if (defined(CLI_TRIE_EN) && CLI_TRIE_EN == 1)
+    cliElement_t* e = cli_find_element_in_trie(ctx, &ctx->buffer[ctx->incTkn], currentMenu, &ctx->incMenuIdx);
+    #else
+    cliElement_t* e = cli_find_element_in_menu(ctx, &ctx->buffer[ctx->incTkn], currentMenu);
+    #endif
+    
+    ctx->buffer[end] = c;
+    
+    if(cli_is_sub_menu(e)){
+        ctx->incMenu = e;
+        ctx->incState = CLI_INC_IDLE;
+    }
+    
+    else if(cli_is_action(e) && CLI_EL_ARGS(e) != NULL){
+        ctx->incAction = e;
+        ctx->incArgs = 0;
+        ctx->argsStr = NULL;
+        ctx->argsCount = 0;
+        ctx->incState = CLI_INC_ARGS;
+    }
+    
+    else{
+        ctx->incState = CLI_INC_FAILED;
+    }
+}
+
+//Verifies the argument received from incTkn
+static void cli_inc_arg(cli_ctx_t* ctx){
+    cliArgsSpec_t const * const argsSpec = cli_get_args_spec(ctx, ctx->incAction);
+    
+    ctx->incState = CLI_INC_FAILED;
+    
+    if(argsSpec == NULL) return;
+    if(ctx->incArgs >= argsSpec->count && !argsSpec->elipsis) return;
+    if(!cli_verify_argument(ctx, ctx->incAction, argsSpec, &ctx->buffer[ctx->incTkn], ctx->incArgs)) return;
+    
+    ctx->incArgs++;
+    ctx->incState = CLI_INC_ARGS;
+}
+
+//Same token boundaries as cli_next_token and cli_arg_str_len, for the character just written at 'pos'
+static void cli_inc_push(cli_ctx_t* ctx, size_t pos){
+    if(pos >= ctx->size){
+        ctx->incState = CLI_INC_TOO_BIG;
+        return;
+    }
+    
+    if(ctx->incState == CLI_INC_FAILED || ctx->incState == CLI_INC_TOO_BIG) return;
+    
+    char const c = ctx->buffer[pos];
+    char const first = ctx->buffer[ctx->incTkn];
+    
+    switch(ctx->incState){
+        case CLI_INC_IDLE : {
+            if(c == ' ') break;
+            
+            ctx->incTkn = pos;
+            ctx->incState = CLI_INC_NAME;
+            break;
+        }
+        
+        case CLI_INC_NAME : {
+            if(c == ' ') cli_inc_name(ctx, pos);
+            break;
+        }
+        
+        case CLI_INC_ARGS : {
+            if(ctx->argsStr == NULL){
+                if(!cli_is_arg_start(c)) break;
+                ctx->argsStr = &ctx->buffer[pos];
+            }
+            
+            else if(c == ' ') break;
+            
+            ctx->incTkn = pos;
+            ctx->incState = CLI_INC_ARG;
+            break;
+        }
+        
+        case CLI_INC_ARG : {
+            if(first == '{'){
+                if(c == '}') cli_inc_arg(ctx);
+            }
+            
+            else if(first == '"'){
+                if(c == '"' && ctx->buffer[pos - 1] != '\\') cli_inc_arg(ctx);
+            }
+            
+            else if(c == ' '){
+                cli_inc_arg(ctx);
+            }
+            
+            break;
+        }
+        
+        default : break;
+    }
+}
+
+//End of the line (already terminated), the line is ready if every argument the action needs is verified
+static void cli_inc_end(cli_ctx_t* ctx){
+    if(ctx->incState == CLI_INC_NAME) cli_inc_name(ctx, ctx->len);
+    
+    //Braces and quotes not closed
+    else if(ctx->incState == CLI_INC_ARG){
+        if(ctx->buffer[ctx->incTkn] == '{' || ctx->buffer[ctx->incTkn] == '"') ctx->incState = CLI_INC_FAILED;
+        else cli_inc_arg(ctx);
+    }
+    
+    if(ctx->incState != CLI_INC_ARGS) return;
+    
+    cliArgsSpec_t const * const argsSpec = cli_get_args_spec(ctx, ctx->incAction);
+    
+    if(argsSpec == NULL || ctx->incArgs < argsSpec->count){
+        ctx->incState = CLI_INC_FAILED;
+        return;
+    }
+    
+    if(ctx->argsStr == NULL) ctx->argsStr = &ctx->buffer[ctx->len];
+    
+    ctx->incState = CLI_INC_READY;
+}
+#endif
+
+static bool cli_get_int_arg(cli_ctx_t* ctx, size_t argNum, int64_t *res, bool isUnsigned){
+    if(ctx == NULL || ctx->currEl == NULL || ctx->argsStr == NULL) {
+        ERR_PRINTLN("Function usage is exculise to functions inside CLI");
+        return false;
+    }
+    
+    size_t const len = ctx->spec.count;
+    
+    if(argNum >= len && !ctx->spec.elipsis) {
+        ERR_PRINTLN("Argument index out of bounds");
+        return false;
+    }
+    
+    if(argNum >= ctx->argsCount){ 
+        ERR_PRINTLN("Argument '%c' index %u not found in buffer", ( (isUnsigned) ? 'u' : 'i' ), (unsigned) argNum);
+        return false; 
+    }
+
+    if( argNum < len && ( (isUnsigned && ctx->spec.types[argNum] != 'u') || (!isUnsigned && ctx->spec.types[argNum] != 'i') ) && ctx->spec.types[argNum] != '*' ) {
+        ERR_PRINTLN("Expected argument of type '%c', but argument list says '%c' in index %u", ( (isUnsigned) ? 'u' : 'i' ) , ctx->spec.types[argNum], (unsigned) argNum);
+        return false;
+    }
+    
+    if( !(ctx->args[argNum].kind & ( (isUnsigned) ? CLI_ARG_KIND_UINT : CLI_ARG_KIND_INT ) ) ){
+        ERR_PRINTLN("Argument index %u is not a valid %s int", (unsigned) argNum, ( (isUnsigned) ? "unsigned" : "signed" ) );
+        return false;
+    }
+    
+    *res = ctx->args[argNum].val.i;
+
+    return true;
+}
+
+static bool cli_get_quotes(cli_ctx_t* ctx, char* base, int32_t argLen, uint8_t buff[], size_t buffLen, size_t *res, bool isString){
+    int pos = 0;
+    bool err = true;
+    int endString = ( (isString == true) ? 1 : 0 );
+    
+    for(int i = 1; i < argLen - 1; i++){
+        
+        if(pos >= buffLen - endString){
+            ERR_PRINTLN("Buffer received is too tiny, exiting...");
+            err = false;
+            break;
+        }
+        
+        if(base[i] == '\\'){
+            switch(base[i + 1]){
+                case '\\' : buff[pos++] = '\\'; i++; break;
+                case '"'  : buff[pos++] = '"';  i++; break;
+                case '0'  : buff[pos++] = '\0'; i++; break;
+                case 'n'  : buff[pos++] = '\n'; i++; break;
+                case 'r'  : buff[pos++] = '\r'; i++; break;
+                
+                default   : buff[pos++] = '\\'; break;
+            }
+            continue;
+        }
+        
+        buff[pos++] = base[i];
+    }
+    
+    if(isString && pos < buffLen) buff[pos++] = '\0';
+    
+    *res = pos;
+    
+    return err;
+}
+
+//Loads 4 characters in a word, first character in the lowest byte whatever the endianness
+static inline uint32_t cli_swar_load(char const* p){
+    return (uint32_t) (uint8_t) p[0] | ( (uint32_t) (uint8_t) p[1] << 8 ) | ( (uint32_t) (uint8_t) p[2] << 16 ) | ( (uint32_t) (uint8_t) p[3] << 24 );
+}
+
+//High bit of each byte set if the byte is >= n (bytes and n must be <= 0x80)
+static inline uint32_t cli_swar_ge(uint32_t x, uint8_t n){
+    return ( (x | CLI_SWAR_H) - n * CLI_SWAR_L ) & CLI_SWAR_H;
+}
+
+//High bit of each byte set if the byte is equal to n
+static inline uint32_t cli_swar_eq(uint32_t x, uint8_t n){
+    uint32_t const y = x ^ (n * CLI_SWAR_L);
+    return ~( ( (y & ~CLI_SWAR_H) + ~CLI_SWAR_H ) | y ) & CLI_SWAR_H;
+}
+
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+//Index of the first '\n' or '\r' of str, n if there is none. The characters are compared a word (4 characters) at a time
+static size_t cli_find_line_end(char const str[], size_t n){
+    size_t i = 0;
+    
+    for(; i + 4 <= n; i += 4){
+        uint32_t x;
+        memcpy(&x, &str[i], sizeof(x));
+        
+        if(cli_swar_eq(x, '\n') | cli_swar_eq(x, '\r')) break;
+    }
+    
+    for(; i < n; i++){
+        if(str[i] == '\n' || str[i] == '\r') return i;
+    }
+    
+    return n;
+}
+#endif //CLI_POLLING_EN
+
+#if (defined(CLI_BUFFER_SWAR_EN) && CLI_BUFFER_SWAR_EN == 1)
+//Decodes the 12 characters "HH HH HH HH " (four 2 digits bytes followed by one space each, the usual layout of big buffers) into 4 bytes.
+//The characters are classified and converted 4 at a time. Returns false without writing anything if src does not follow that layout
+static bool cli_swar_decode_4_bytes(char const* src, uint8_t dst[4]){
+    static uint32_t const digitPos[3] = { 0x80008080UL, 0x80800080UL, 0x00808000UL };   //"HH H", "H HH", " HH "
+    static uint32_t const spacePos[3] = { 0x00800000UL, 0x00008000UL, 0x80000080UL };
+    
+    uint32_t nibbles[3];
+    uint32_t letters[3];
+    
+    for(int k = 0; k < 3; k++){
+        uint32_t const x = cli_swar_load(&src[4 * k]);
+        uint32_t const lx = x | (0x20 * CLI_SWAR_L);
+        
+        if(x & CLI_SWAR_H) return false;
+        
+        uint32_t const digit = cli_swar_ge(x, '0') & ~cli_swar_ge(x, '9' + 1);
+        letters[k] = cli_swar_ge(lx, 'a') & ~cli_swar_ge(lx, 'f' + 1);
+        
+        if( ( (digit | letters[k]) & digitPos[k] ) != digitPos[k] ) return false;
+        if( ( cli_swar_eq(x, ' ') & spacePos[k] ) != spacePos[k] ) return false;
+        
+        //'0'-'9' -> 0-9, 'a'-'f' and 'A'-'F' -> 10-15
+        nibbles[k] = (x & (0x0F * CLI_SWAR_L)) + ( (x >> 6) & CLI_SWAR_L ) * 9;
+    }
+    
+    for(int t = 0; t < 4; t++){
+        int const p = 3 * t;        //Position of the first digit in the 12 characters
+        int const q = p + 1;
+        
+        uint8_t const hi = (uint8_t) (nibbles[p / 4] >> (8 * (p % 4)));
+        uint8_t const lo = (uint8_t) (nibbles[q / 4] >> (8 * (q % 4)));
+        bool const isHex = ( (letters[p / 4] >> (8 * (p % 4))) | (letters[q / 4] >> (8 * (q % 4))) ) & 0x80;
+        
+        dst[t] = (uint8_t) ( (isHex) ? (hi << 4) | lo : hi * 10 + lo );
+    }
+    
+    return true;
+}
+#endif
+
+static bool cli_get_curly_braces(cli_ctx_t* ctx, char* base, int32_t argLen, uint8_t buff[], size_t buffLen, size_t *res,  bool isString){
+    int pos = 0;
+    bool err = true;
+    int endString = ( (isString == true) ? 1 : 0 );
+
+    int i = 1;
+
+    while(i < argLen - 1){
+        
+        if(base[i] == ' '){
+            i++;
+            continue;
+        }
+        
+        #if (defined(CLI_BUFFER_SWAR_EN) && CLI_BUFFER_SWAR_EN == 1)
+        if(i + 12 <= argLen - 1 && pos + 4 + endString <= (int) buffLen && cli_swar_decode_4_bytes(&base[i], &buff[pos])){
+            pos += 4;
+            i += 12;
+            continue;
+        }
+        #endif
+
+        int32_t sz = 0;
+        
+        while(i + sz < argLen - 1 && base[i + sz] != ' ') sz++;
+        
+        uint64_t num = 0;
+        
+        if(!cli_parse_int(ctx, &base[i], sz, true, 8, &num, false)){
+            ERR_PRINTLN("Buffer argument error in byte number %u : Exceeded maximum value", pos);
+            err = false;
+            break;
+        }
+        
+        if(pos >= buffLen - endString){
+            ERR_PRINTLN("Buffer received is too tiny, exiting...");
+            err = false;
+            break;
+        }
+        
+        buff[pos++] = (uint8_t) num;
+        
+        i += sz;
+    }
+    
+    if(isString && pos < buffLen) buff[pos++] = '\0';
+    
+    *res = pos;
+    
+    return err;
+}
+
+static bool cli_get_hex_run(cli_ctx_t* ctx, char* base, int32_t argLen, uint8_t buff[], size_t buffLen, size_t *res, bool isString){
+    size_t const endString = ( (isString == true) ? 1 : 0 );
+    size_t count = (size_t) (argLen - 1) / 2;
+    size_t pos = 0;
+    bool err = true;
+    char const* src = &base[1];
+    
+    if(count + endString > buffLen){
+        ERR_PRINTLN("Buffer received is too tiny, exiting...");
+        err = false;
+        count = ( (buffLen > endString) ? buffLen - endString : 0 );
+    }
+    
+    #if (defined(CLI_BUFFER_SWAR_EN) && CLI_BUFFER_SWAR_EN == 1)
+    //Characters were validated by cli_verify_buffer, 4 digits (2 bytes) are converted per word
+    for(; pos + 2 <= count; pos += 2, src += 4){
+        uint32_t const x = cli_swar_load(src);
+        uint32_t const nibbles = (x & (0x0F * CLI_SWAR_L)) + ( (x >> 6) & CLI_SWAR_L ) * 9;
+        
+        buff[pos]     = (uint8_t) ( ( (nibbles & 0xFF) << 4 ) | ( (nibbles >> 8) & 0xFF ) );
+        buff[pos + 1] = (uint8_t) ( ( ( (nibbles >> 16) & 0xFF ) << 4 ) | (nibbles >> 24) );
+    }
+    #endif
+    
+    for(; pos < count; pos++, src += 2){
+        buff[pos] = (uint8_t) ( (cli_digit_value(src[0]) << 4) | cli_digit_value(src[1]) );
+    }
+    
+    if(isString && pos < buffLen) buff[pos++] = '\0';
+    
+    *res = pos;
+    
+    return err;
+}
+
+static bool cli_get_base64(cli_ctx_t* ctx, char* base, int32_t argLen, uint8_t buff[], size_t buffLen, size_t *res, bool isString){
+    size_t const endString = ( (isString == true) ? 1 : 0 );
+    int32_t const n = cli_base64_length(base, argLen);
+    size_t pos = 0;
+    bool err = true;
+    uint32_t acc = 0;
+    uint8_t bits = 0;
+    
+    for(int32_t i = 1; i <= n; i++){
+        acc = (acc << 6) | cli_base64_value(base[i]);
+        bits += 6;
+        
+        if(bits < 8) continue;
+        
+        if(pos + endString >= buffLen){
+            ERR_PRINTLN("Buffer received is too tiny, exiting...");
+            err = false;
+            break;
+        }
+        
+        bits -= 8;
+        buff[pos++] = (uint8_t) (acc >> bits);
+    }
+    
+    if(isString && pos < buffLen) buff[pos++] = '\0';
+    
+    *res = pos;
+    
+    return err;
+}
+
+static bool cli_get_buff_arg(cli_ctx_t* ctx, size_t argNum, uint8_t buff[], size_t buffLen, size_t *res, bool isString){
+    if(ctx == NULL || ctx->currEl == NULL || ctx->argsStr == NULL) {
+        ERR_PRINTLN("Function usage is exculise to functions inside CLI");
+        return false;
+    }
+    
+    size_t const len = ctx->spec.count;
+    
+    if(argNum >= len && !ctx->spec.elipsis) { 
+        ERR_PRINTLN("Argument index out of bounds");
+        return false;
+    }
+    
+    if(argNum >= ctx->argsCount) {
+        ERR_PRINTLN("Argument '%c' number %u not found in buffer", ( (isString) ? 's' : 'b' ), (unsigned) argNum );
+        return false;
+    }
+    
+    if( argNum < len && ( (!isString && ctx->spec.types[argNum] != 'b') || (isString && ctx->spec.types[argNum] != 's' ) ) && ctx->spec.types[argNum] != '*' ) {
+        ERR_PRINTLN("Expected argument of type 's', but argument list says %c in index %u", ctx->spec.types[argNum], (unsigned) argNum);
+        return false;
+    }
+    
+    if( !(ctx->args[argNum].kind & CLI_ARG_KIND_BUFFER) ) { 
+        ERR_PRINTLN("Argument %u is not a valid buffer", (unsigned) argNum);
+        return false;
+    }
+    
+    char* argBase = ctx->argsStr + ctx->args[argNum].start;
+    int32_t argLen = ctx->args[argNum].len;
+
+    if(argBase[0] == '{') 
+        return cli_get_curly_braces(ctx, argBase, argLen, buff, buffLen, res, isString);
+    else if(argBase[0] == '"')
+        return cli_get_quotes(ctx, argBase, argLen, buff, buffLen, res, isString);
+    else if(argBase[0] == '#')
+        return cli_get_hex_run(ctx, argBase, argLen, buff, buffLen, res, isString);
+    else if(argBase[0] == '$')
+        return cli_get_base64(ctx, argBase, argLen, buff, buffLen, res, isString);
+    
+    ERR_PRINTLN("Buffer does not begin with \", {, # nor $");
+    return false;
+}
+
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+//Appends n characters (no line end) to the line being received in the ring, or marks the line as dropped if they do not fit
+static void cli_rx_push(cli_ctx_t* ctx, char const src[], size_t n){
+    if(ctx->rxDrop != CLI_NONE || n == 0) return;
+    
+    size_t const lineLen = ctx->rxWrite - ctx->rxLine;
+    
+    //One more place is kept for the terminator
+    if(lineLen + n >= ctx->size){
+        ctx->rxDrop = CLI_TOO_BIG;
+        return;
+    }
+    
+    size_t const pos = CLI_RX_INDEX(ctx, ctx->rxWrite);
+    
+    #if (defined(CLI_ZERO_COPY_EN) && CLI_ZERO_COPY_EN == 1)
+    //Lines are parsed in place, so they are kept contiguous : a line reaching the end of the ring is moved to its beginning, and the 
+    //end of the ring is skipped by the consumer (marked by '\n', never stored otherwise). This happens at most once per lap
+    if(pos + n + 1 > CLI_RX_SIZE(ctx)){
+        size_t const lineStart = CLI_RX_INDEX(ctx, ctx->rxLine);
+        size_t const skip = CLI_RX_SIZE(ctx) - lineStart;
+        
+        //Nothing is waiting nor being executed : the consumer does not read the indexes until the next line is published, so the ring
+        //restarts at the next lap and the line only needs its own length
+        bool const empty = ( ctx->rxLinesOut == ctx->rxLinesIn );
+        
+        if(!empty && ctx->rxLine + skip + lineLen + n - ctx->rxTail >= CLI_RX_SIZE(ctx)){
+            ctx->rxDrop = CLI_RX_FULL;
+            return;
+        }
+        
+        memmove(CLI_RX_BUFFER(ctx), &CLI_RX_BUFFER(ctx)[lineStart], lineLen);
+        
+        if(empty){
+            ctx->rxHead = ctx->rxLine + skip;
+            ctx->rxTail = ctx->rxLine + skip;
+        }
+        
+        else{
+            CLI_RX_BUFFER(ctx)[lineStart] = '\n';
+        }
+        
+        ctx->rxLine += skip;
+        ctx->rxWrite = ctx->rxLine + lineLen;
+        
+        memcpy(&CLI_RX_BUFFER(ctx)[lineLen], src, n);
+        ctx->rxWrite += n;
+        return;
+    }
+    #endif
+    
+    if(ctx->rxWrite + n - ctx->rxTail >= CLI_RX_SIZE(ctx)){
+        ctx->rxDrop = CLI_RX_FULL;
+        return;
+    }
+    
+    size_t const first = ( (n < CLI_RX_SIZE(ctx) - pos) ? n : CLI_RX_SIZE(ctx) - pos );
+    
+    memcpy(&CLI_RX_BUFFER(ctx)[pos], src, first);
+    memcpy(CLI_RX_BUFFER(ctx), &src[first], n - first);
+    
+    ctx->rxWrite += n;
+}
+
+//Terminates the line being received and publishes it to cli_ctx_treat_command
+static cli_status_e cli_rx_end_line(cli_ctx_t* ctx){
+    if(ctx->rxDrop != CLI_NONE){
+        cli_status_e const status = ctx->rxDrop;
+        
+        ctx->rxWrite = ctx->rxLine = ctx->rxHead;
+        ctx->rxDrop = CLI_NONE;
+        
+        if(status == CLI_TOO_BIG) ERR_PRINT("COMMAND TOO LARGE! Enter new command = ");
+        else ERR_PRINT("RECEPTION FULL! Enter new command = ");
+        
+        return status;
+    }
+    
+    //cli_rx_push accepts characters only if the terminator still fits after them (rxWrite - rxTail < size), so only a line without any
+    //character can find the ring full, when the lines waiting use all of it
+    if(ctx->rxWrite == ctx->rxLine && ctx->rxWrite - ctx->rxTail >= CLI_RX_SIZE(ctx)){
+        ERR_PRINT("RECEPTION FULL! Enter new command = ");
+        return CLI_RX_FULL;
+    }
+    
+    if(ctx->rxLinesIn - ctx->rxLinesOut >= CLI_RX_QUEUE_DEPTH){
+        ctx->rxWrite = ctx->rxLine = ctx->rxHead;
+        ERR_PRINT("COMMAND QUEUE FULL! Enter new command = ");
+        return CLI_RX_FULL;
+    }
+    
+    CLI_RX_BUFFER(ctx)[CLI_RX_INDEX(ctx, ctx->rxWrite++)] = '\0';
+    
+    //The characters of the line must be visible to the consumer before the line is
+    CLI_MEMORY_BARRIER();
+    ctx->rxHead = ctx->rxLine = ctx->rxWrite;
+    ctx->rxLinesIn++;
+    
+    return CLI_WAITING_TREATMENT;
+}
+#endif //CLI_POLLING_EN
+
+//Destination of the text produced by cli_format
+typedef void (*cliWrite_t)(void* arg, char const data[], size_t len);
+
+#if (defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+    #define CLI_FORMAT_NUM_LEN          24
+#else
+    //Numbers are converted by the C library, one conversion at a time
+    #define CLI_FORMAT_NUM_LEN          64
+    #define CLI_FORMAT_NUM(T)           snprintf(num, sizeof(num), spec, (int) width, prec, va_arg(args, T))
+#endif
+
+static void cli_format_pad(cliWrite_t write, void* arg, char c, size_t n){
+    static char const spaces[] = "                ";
+    static char const zeros[]  = "0000000000000000";
+    
+    char const * const pad = ( (c == '0') ? zeros : spaces );
+    
+    while(n > 0){
+        size_t const len = ( (n < sizeof(spaces) - 1) ? n : sizeof(spaces) - 1 );
+        
+        write(arg, pad, len);
+        n -= len;
+    }
+}
+
+//Minimal vprintf : %s %c %d %i %u %x %X %%, '-' and '0' flags, width and precision of %s (digits or '*') and 'l', 'll', 'z' sizes.
+//No float. Text between specifiers and padding are given to write by blocks, and integers fitting in 32 bits are converted with 32
+//bits divisions. Without the built-in formatter, it streams the long prints of cli_ctx_printf : every other conversion is then given
+//to snprintf, with its flags and sizes (CLI_FORMAT_NUM_LEN - 1 characters at most per conversion, never for the whole text)
+static void cli_format(cliWrite_t write, void* arg, char const* fmt, va_list args){
+    while(*fmt != '\0'){
+        char const* run = fmt;
+        
+        while(*fmt != '\0' && *fmt != '%') fmt++;
+        
+        if(fmt != run) write(arg, run, (size_t) (fmt - run));
+        
+        if(*fmt == '\0') break;
+        
+        fmt++;
+        
+        bool left = false;
+        char padChar = ' ';
+        size_t width = 0;
+        int prec = -1;          //-1 : no precision
+        uint8_t size = 0;       //0 : int, 1 : long, 2 : long long, 3 : size_t, 4 : intmax_t, 5 : ptrdiff_t, 6 : long double
+        
+#if !(defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+        char const * const flags = fmt;
+#endif
+        
+        for(;; fmt++){
+            if(*fmt == '-') left = true;
+            else if(*fmt == '0') padChar = '0';
+#if !(defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+            else if(*fmt == '+' || *fmt == ' ' || *fmt == '#') continue;
+#endif
+            else break;
+        }
+        
+#if !(defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+        size_t const flagsLen = (size_t) (fmt - flags);
+#endif
+        
+        if(*fmt == '*'){
+            int const w = va_arg(args, int);
+            
+            if(w < 0) left = true;
+            
+            width = (size_t) ( (w < 0) ? -w : w );
+            fmt++;
+        }
+        
+        while('0' <= *fmt && *fmt <= '9') width = width * 10 + (size_t) (*fmt++ - '0');
+        
+        if(*fmt == '.'){
+            prec = 0;
+            
+            if(*++fmt == '*'){
+                prec = va_arg(args, int);
+                fmt++;
+            }
+            
+            while('0' <= *fmt && *fmt <= '9') prec = prec * 10 + (*fmt++ - '0');
+        }
+        
+#if !(defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+        char const * const sizeStr = fmt;
+        
+        if(*fmt == 'h'){
+            if(*++fmt == 'h') fmt++;
+        }
+        else if(*fmt == 'j'){ size = 4; fmt++; }
+        else if(*fmt == 't'){ size = 5; fmt++; }
+        else if(*fmt == 'L'){ size = 6; fmt++; }
+#endif
+        
+        if(*fmt == 'l'){
+            size = 1;
+            if(*++fmt == 'l'){ size = 2; fmt++; }
+        }
+        else if(*fmt == 'z'){
+            size = 3;
+            fmt++;
+        }
+        
+        char num[CLI_FORMAT_NUM_LEN];
+        char const* str = num;
+        size_t len = 1;
+        
+        switch(*fmt){
+            case 's' : {
+                str = va_arg(args, char const*);
+                
+                if(str == NULL) str = "(null)";
+                
+                if(prec < 0){
+                    len = strlen(str);
+                }
+                else{
+                    char const * const end = memchr(str, '\0', (size_t) prec);
+                    
+                    len = ( (end != NULL) ? (size_t) (end - str) : (size_t) prec );
+                }
+                break;
+            }
+            
+            case 'c' : num[0] = (char) va_arg(args, int); break;
+            
+#if (defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+            case 'd' :
+            case 'i' :
+            case 'u' :
+            case 'x' :
+            case 'X' : {
+                uint32_t const base = ( (*fmt == 'x' || *fmt == 'X') ? 16 : 10 );
+                char const * const digits = ( (*fmt == 'x') ? "0123456789abcdef" : "0123456789ABCDEF" );
+                bool neg = false;
+                uint64_t v = 0;
+                
+                if(*fmt == 'd' || *fmt == 'i'){
+                    int64_t const sv = ( (size == 2) ? va_arg(args, long long) : (size == 1) ? va_arg(args, long) : (size == 3) ? (int64_t) va_arg(args, size_t) : va_arg(args, int) );
+                    
+                    neg = (sv < 0);
+                    v = ( (neg) ? (uint64_t) 0 - (uint64_t) sv : (uint64_t) sv );
+                }
+                else{
+                    v = ( (size == 2) ? va_arg(args, unsigned long long) : (size == 1) ? va_arg(args, unsigned long) : (size == 3) ? va_arg(args, size_t) : va_arg(args, unsigned int) );
+                }
+                
+                char* p = &num[sizeof(num)];
+                
+                if(v <= UINT32_MAX){
+                    uint32_t w = (uint32_t) v;
+                    do{ *--p = digits[w % base]; w /= base; }while(w != 0);
+                }
+                else{
+                    do{ *--p = digits[v % base]; v /= base; }while(v != 0);
+                }
+                
+                if(neg) *--p = '-';
+                
+                str = p;
+                len = (size_t) (&num[sizeof(num)] - p);
+                
+                //The sign goes before the zeros
+                if(neg && padChar == '0' && !left && width > len){
+                    write(arg, str++, 1);
+                    len--;
+                    width--;
+                }
+                break;
+            }
+#else
+            case 'd' :
+            case 'i' :
+            case 'o' :
+            case 'u' :
+            case 'x' :
+            case 'X' :
+            case 'e' :
+            case 'E' :
+            case 'f' :
+            case 'F' :
+            case 'g' :
+            case 'G' :
+            case 'a' :
+            case 'A' :
+            case 'p' : {
+                //Same conversion without '*', the width and the precision are always given as arguments, a negative precision is ignored
+                char spec[16] = "%";
+                size_t const sizeLen = (size_t) (fmt - sizeStr);
+                
+                strncat(spec, flags, ( (flagsLen < 5) ? flagsLen : 5 ));
+                if(left) strcat(spec, "-");
+                strcat(spec, "*.*");
+                strncat(spec, sizeStr, sizeLen);
+                strncat(spec, fmt, 1);
+                
+                int res = 0;
+                
+                if(*fmt == 'd' || *fmt == 'i'){
+                    switch(size){
+                        case 1 : res = CLI_FORMAT_NUM(long); break;
+                        case 2 : res = CLI_FORMAT_NUM(long long); break;
+                        case 3 : res = CLI_FORMAT_NUM(size_t); break;
+                        case 4 : res = CLI_FORMAT_NUM(intmax_t); break;
+                        case 5 : res = CLI_FORMAT_NUM(ptrdiff_t); break;
+                        default : res = CLI_FORMAT_NUM(int); break;
+                    }
+                }
+                else if(*fmt == 'o' || *fmt == 'u' || *fmt == 'x' || *fmt == 'X'){
+                    switch(size){
+                        case 1 : res = CLI_FORMAT_NUM(unsigned long); break;
+                        case 2 : res = CLI_FORMAT_NUM(unsigned long long); break;
+                        case 3 : res = CLI_FORMAT_NUM(size_t); break;
+                        case 4 : res = CLI_FORMAT_NUM(uintmax_t); break;
+                        case 5 : res = CLI_FORMAT_NUM(ptrdiff_t); break;
+                        default : res = CLI_FORMAT_NUM(unsigned int); break;
+                    }
+                }
+                else if(*fmt == 'p'){
+                    res = CLI_FORMAT_NUM(void*);
+                }
+                else{
+                    res = ( (size == 6) ? CLI_FORMAT_NUM(long double) : CLI_FORMAT_NUM(double) );
+                }
+                
+                len = ( (res < 0) ? 0 : ( (size_t) res < sizeof(num) ) ? (size_t) res : sizeof(num) - 1 );
+                width = 0;
+                break;
+            }
+#endif
+            
+            case '\0' : return;
+            
+            default : num[0] = *fmt; break;
+        }
+        
+        if(!left && width > len) cli_format_pad(write, arg, padChar, width - len);
+        
+        write(arg, str, len);
+        
+        if(left && width > len) cli_format_pad(write, arg, ' ', width - len);
+        
+        fmt++;
+    }
+}
+
+//Output of the prints without context output
+static void cli_write_sink(void* arg, char const data[], size_t len){
+    (void) arg;
+    
+    #if (defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+    cli_write(data, len);
+    #else
+    cli_printf("%.*s", (int) len, data);
+    #endif
+}
+
+//Formats the text of cli_ctx_printf for write. Without the built-in formatter, the text is formatted at once by vsnprintf if it fits
+//in CLI_CTX_PRINT_LINE_LEN, and streamed by cli_format otherwise : the prints are never truncated
+static void cli_vprint(cliWrite_t write, void* arg, char const* fmt, va_list args){
+#if (defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+    cli_format(write, arg, fmt, args);
+#else
+    char line[CLI_CTX_PRINT_LINE_LEN];
+    va_list copy;
+    
+    va_copy(copy, args);
+    int const len = vsnprintf(line, sizeof(line), fmt, copy);
+    va_end(copy);
+    
+    if(len < 0) return;
+    
+    if( (size_t) len < sizeof(line) ) write(arg, line, (size_t) len);
+    else cli_format(write, arg, fmt, args);
+#endif
+}
+
+#if (defined(CLI_TX_BUFFER_SIZE) && CLI_TX_BUFFER_SIZE > 0)
+//Hands the oldest contiguous part of the TX ring to the flush callback, unless a transfer is in progress. Called by the CLI, and by
+//cli_ctx_tx_done at the end of each transfer (a transfer is never started by both at the same time, txBusy is 0 only when idle)
+static void cli_tx_kick(cli_ctx_t* ctx){
+    if(ctx->flush == NULL || ctx->txBusy != 0) return;
+    
+    size_t const tail = ctx->txTail;
+    size_t const pending = ctx->txHead - tail;
+    
+    if(pending == 0) return;
+    
+    //The characters are read by the transfer only after txHead
+    CLI_MEMORY_BARRIER();
+    
+    size_t const pos = tail % CLI_TX_BUFFER_SIZE;
+    size_t const len = ( (pending < CLI_TX_BUFFER_SIZE - pos) ? pending : CLI_TX_BUFFER_SIZE - pos );
+    
+    ctx->txBusy = len;
+    ctx->flush(ctx->flushArg, &ctx->txRing[pos], len);
+}
+
+//Never waits for cli_ctx_tx_done, it could never come if the CLI runs in the task or the interrupt that calls it : what does not fit
+//in the ring is dropped and counted
+static void cli_tx_write(cli_ctx_t* ctx, char const data[], size_t n){
+    while(n > 0){
+        size_t room = CLI_TX_BUFFER_SIZE - (ctx->txHead - ctx->txTail);
+        
+        //Ring full, sends what it holds (a blocking flush releases it before returning)
+        if(room == 0){
+            cli_tx_kick(ctx);
+            room = CLI_TX_BUFFER_SIZE - (ctx->txHead - ctx->txTail);
+            
+            if(room == 0){
+                ctx->txDropped += n;
+                return;
+            }
+        }
+        
+        size_t const pos = ctx->txHead % CLI_TX_BUFFER_SIZE;
+        size_t len = ( (n < room) ? n : room );
+        
+        if(len > CLI_TX_BUFFER_SIZE - pos) len = CLI_TX_BUFFER_SIZE - pos;
+        
+        memcpy(&ctx->txRing[pos], data, len);
+        
+        //The characters are published only once in the ring, cli_ctx_tx_done may start a transfer from an interrupt
+        CLI_MEMORY_BARRIER();
+        ctx->txHead += len;
+        data += len;
+        n -= len;
+    }
+}
+
+static void cli_tx_sink(void* arg, char const data[], size_t len){
+    cli_tx_write( (cli_ctx_t*) arg, data, len );
+}
+#endif
+
+#if (defined(CLI_MENU_PRINT_ENABLE) && CLI_MENU_PRINT_ENABLE == 1)
+//The length is generated with the text, it is written as is whatever its size (a vprintf like output gets it as "%.*s")
+static void cli_ctx_write(cli_ctx_t* ctx, char const data[], size_t len){
+#if (defined(CLI_TX_BUFFER_SIZE) && CLI_TX_BUFFER_SIZE > 0)
+    if(ctx != NULL && ctx->flush != NULL){
+        cli_tx_write(ctx, data, len);
+        return;
+    }
+#endif
+
+    if(ctx != NULL && ctx->print != NULL) cli_ctx_printf(ctx, "%.*s", (int) len, data);
+    else cli_write_sink(NULL, data, len);
+}
+#endif
+
+//Refuses (size 0, nothing received nor treated) a zero copy buffer whose size is not a power of 2, the ring indexes are masked
+static void cli_ctx_set_buffer(cli_ctx_t* ctx, char buffer[], size_t size){
+    ctx->buffer = buffer;
+    ctx->size = size;
+    
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1) && (defined(CLI_ZERO_COPY_EN) && CLI_ZERO_COPY_EN == 1)
+    if( (size & (size - 1)) != 0 ){
+        ERR_PRINTLN("In zero copy mode, the size of the buffer must be a power of 2");
+        ctx->size = 0;
+    }
+#endif
+}
+
+//The functions without context give the buffer at each call, it is checked again only when it changes
+static void cli_set_default_buffer(char cliBuffer[], size_t maxLen){
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1) && (defined(CLI_ZERO_COPY_EN) && CLI_ZERO_COPY_EN == 1)
+    if(cliDefaultCtx.buffer == cliBuffer && cliDefaultSize == maxLen) return;
+    
+    cliDefaultSize = maxLen;
+#endif
+    
+    cli_ctx_set_buffer(&cliDefaultCtx, cliBuffer, maxLen);
+}
+
+/**********************************************
+ * PRIVATE / PUBLIC FUNCTIONS
+ *********************************************/
+ 
+void cli_ctx_treat_command(cli_ctx_t* ctx){
+    if(ctx == NULL) return;
+    if(ctx->size == 0) return;
+    if(ctx->buffer == NULL) return;
+    
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+    //The indexes are read only once a line is published, the producer may rewind them while the ring is empty
+    if(ctx->rxLinesIn == ctx->rxLinesOut) return;
+    
+    //Lines are published by the producer only once complete, after their characters
+    CLI_MEMORY_BARRIER();
+    
+    size_t tail = ctx->rxTail;
+    
+    #if (defined(CLI_ZERO_COPY_EN) && CLI_ZERO_COPY_EN == 1)
+    //End of the ring skipped by a line moved to its beginning
+    if(CLI_RX_BUFFER(ctx)[CLI_RX_INDEX(ctx, tail)] == '\n') tail += CLI_RX_SIZE(ctx) - CLI_RX_INDEX(ctx, tail);
+    
+    ctx->line = &CLI_RX_BUFFER(ctx)[CLI_RX_INDEX(ctx, tail)];
+    tail += strlen(ctx->line) + 1;
+    
+    DBG_PRINTLN("Cmd rcv = '%s'", ctx->line);
+    
+    //The line is parsed in place, its place in the ring is released only once the command is executed
+    cli_find_action(ctx);
+    
+    CLI_MEMORY_BARRIER();
+    ctx->rxTail = tail;
+    ctx->rxLinesOut++;
+    #else
+    size_t len = 0;
+    
+    while(CLI_RX_BUFFER(ctx)[CLI_RX_INDEX(ctx, tail)] != '\0') ctx->buffer[len++] = CLI_RX_BUFFER(ctx)[CLI_RX_INDEX(ctx, tail++)];
+    
+    ctx->buffer[len] = '\0';
+    
+    //The line is copied, its place in the ring can be reused while the command is executed
+    CLI_MEMORY_BARRIER();
+    ctx->rxTail = tail + 1;
+    ctx->rxLinesOut++;
+    
+    DBG_PRINTLN("Cmd rcv = '%s'", ctx->buffer);
+    
+    ctx->line = ctx->buffer;
+    cli_find_action(ctx);
+    #endif
+#else
+    ctx->line = ctx->buffer;
+    
+    #if (defined(CLI_INCREMENTAL_EN) && CLI_INCREMENTAL_EN == 1)
+    if(ctx->incState == CLI_INC_READY){
+        CLI_TREAT_START(ctx);
+        cli_call_action(ctx, ctx->incAction);
+    }
+    else{
+        cli_find_action(ctx);
+    }
+    
+    cli_inc_reset(ctx);
+    #else
+    cli_find_action(ctx);
+    #endif
+    
+    //The parser stops at the terminator, bytes left after it by longer commands are never read
+    ctx->len = 0;
+    ctx->buffer[0] = '\0';
+#endif //CLI_POLLING_EN
+    
+    ctx->line = NULL;
+    
+    DBG_PRINT("Cmd treated, enter new command = ");
+    
+#if (defined(CLI_TX_BUFFER_SIZE) && CLI_TX_BUFFER_SIZE > 0)
+    //Everything the command printed leaves in as few transfers as possible
+    cli_tx_kick(ctx);
+#endif
+}
+
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+void cli_treat_command(char cliBuffer[], size_t maxLen){
+    cli_set_default_buffer(cliBuffer, maxLen);
+    
+    cli_ctx_treat_command(&cliDefaultCtx);
+}
+#endif //CLI_POLLING_EN
+
+/**********************************************
+ * PUBLIC FUNCTIONS
+ *********************************************/
+
+void cli_ctx_init(cli_ctx_t* ctx, char buffer[], size_t size){
+    if(ctx == NULL) return;
+    
+    memset(ctx, 0, sizeof(cli_ctx_t));
     
-    MENU_PRINTF("Menu '%s' - %s\r\n", currentMenu->name, currentMenu->desc);
-    cli_print_menu(currentMenu);
+    cli_ctx_set_buffer(ctx, buffer, size);
 }
 
-static bool cli_buff_element_is_hex(char* base, size_t argLen){
-    if(base[0] == '0' && tolower(base[1]) == 'x') return true;
+void cli_ctx_set_output(cli_ctx_t* ctx, cliPrint_t print, void* arg){
+    if(ctx == NULL) return;
     
-    for(size_t i = 0; i < argLen; i++){
-        if('a' <= tolower(base[i]) && tolower(base[i]) <= 'f') return true;
-    }
-    
-    return false;
+    ctx->print = print;
+    ctx->printArg = arg;
 }
 
-static bool cli_get_int_arg(size_t argNum, int64_t *res, bool isUnsigned){
-    if(currEl == NULL || argsStr == NULL) {
-        ERR_PRINTLN("Function usage is exculise to functions inside CLI");
-        return false;
-    }
-    
-    if(currEl->args == NULL) {
-        ERR_PRINTLN("Argument string is null");
-        return false;
-    }
-    
-    bool elipsisPresent = false;
-    int64_t len = cli_verify_args_str(currEl, &elipsisPresent);
+void cli_ctx_printf(cli_ctx_t* ctx, char const * const str, ...){
+    va_list args;
+    va_start(args, str);
     
-    if(argNum >= len && !elipsisPresent) {
-        ERR_PRINTLN("Argument index out of bounds");
-        return false;
+#if (defined(CLI_TX_BUFFER_SIZE) && CLI_TX_BUFFER_SIZE > 0)
+    if(ctx != NULL && ctx->flush != NULL){
+        cli_vprint(cli_tx_sink, ctx, str, args);
+        va_end(args);
+        return;
     }
+#endif
     
-    char* argBase = argsStr;
-    
-    for(size_t i = 0; i < argNum; i++)
-        argBase = cli_go_to_next_argument(argBase);
-        
-    if(argBase[0] == '\0'){ 
-        ERR_PRINTLN("Argument '%c' index %u not found in buffer", ( (isUnsigned) ? 'u' : 'i' ), argNum);
-        return false; 
-    }
-
-    if( argNum < len && ( (isUnsigned && currEl->args[argNum] != 'u') || (!isUnsigned && currEl->args[argNum] != 'i') ) && currEl->args[argNum] != '*' ) {
-        ERR_PRINTLN("Expected argument of type '%c', but argument list says '%c' in index %u", ( (isUnsigned) ? 'u' : 'i' ) , currEl->args[argNum], argNum);
-        return false;
+    if(ctx != NULL && ctx->print != NULL){
+        ctx->print(ctx->printArg, str, args);
     }
-    else if(argNum >= len || currEl->args[argNum] == '*'){
-        if(!cli_verify_int(argBase, isUnsigned, true)) return false;
+    else{
+        //cli_printf has no va_list version, the string is formatted here first
+        cli_vprint(cli_write_sink, NULL, str, args);
     }
-        
-    int32_t argLen = cli_arg_str_len(argBase);
     
-    int num_base = ( (cli_buff_element_is_hex(argBase, argLen) == true) ? 16 : 10 );
-        
-    *res = strtol(argBase, NULL, num_base);
-
-    return true;
+    va_end(args);
 }
 
-static bool cli_get_quotes(char* base, int32_t argLen, uint8_t buff[], size_t buffLen, size_t *res, bool isString){
-    int pos = 0;
-    bool err = true;
-    int endString = ( (isString == true) ? 1 : 0 );
+#if (defined(CLI_STATS_EN) && CLI_STATS_EN == 1)
+void cli_ctx_print_stats(cli_ctx_t* ctx){
+    BASE_PRINTLN("%-20s %10s %10s %10s %10s %10s %10s %10s", "Action", "count", "parse min", "parse mean", "parse max", "exec min", "exec mean", "exec max");
     
-    for(int i = 1; i < argLen - 1; i++){
+    //Each line is copied under CLI_LOCK, the lock is not held while printing
+    for(size_t i = 0;; i++){
+        CLI_LOCK();
         
-        if(pos >= buffLen - endString){
-            ERR_PRINTLN("Buffer received is too tiny, exiting...");
-            err = false;
-            break;
-        }
+        bool const last = (i >= cliStatsCount);
+        cliStats_t s;
         
-        if(base[i] == '\\'){
-            switch(base[i + 1]){
-                case '\\' : buff[pos++] = '\\'; i++; break;
-                case '"'  : buff[pos++] = '"';  i++; break;
-                case '0'  : buff[pos++] = '\0'; i++; break;
-                case 'n'  : buff[pos++] = '\n'; i++; break;
-                case 'r'  : buff[pos++] = '\r'; i++; break;
-                
-                default   : buff[pos++] = '\\'; break;
-            }
-            continue;
-        }
+        if(!last) s = cliStats[i];
         
-        buff[pos++] = base[i];
+        CLI_UNLOCK();
+        
+        if(last) break;
+        
+        BASE_PRINTLN("%-20s %10u %10u %10u %10u %10u %10u %10u", ( (CLI_EL_NAME(s.el) == NULL) ? "NULL_NAME" : CLI_EL_NAME(s.el) ), (unsigned) s.count,
+                     (unsigned) s.parse.min, (unsigned) (s.parse.sum / s.count), (unsigned) s.parse.max,
+                     (unsigned) s.exec.min, (unsigned) (s.exec.sum / s.count), (unsigned) s.exec.max);
     }
     
-    if(isString && pos < buffLen) buff[pos++] = '\0';
+    CLI_LOCK();
     
-    *res = pos;
+    uint32_t const others = cliStatsOthers;
     
-    return err;
+    cliStatsCount = 0;
+    cliStatsOthers = 0;
+    
+    CLI_UNLOCK();
+    
+    if(others != 0) BASE_PRINTLN("%-20s %10u", "others", (unsigned) others);
+    
+    BASE_PRINTLN("");
 }
 
-static bool cli_get_curly_braces(char* base, int32_t argLen, uint8_t buff[], size_t buffLen, size_t *res,  bool isString){
-    int pos = 0;
-    bool err = true;
-    int endString = ( (isString == true) ? 1 : 0 );
+void cli_print_stats(void){
+    cli_ctx_print_stats(cliCurrCtx);
+}
+#endif
 
-    for(int i = 1; i < argLen - 1; i++){
-        
-        if(base[i] == ' ') continue;
+#if (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+void cli_typed_action(void){}
+#endif
+
+#if (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1)
+void cli_registry_init(void){
+    cli_registry_sort();
+}
+#endif
 
-        int32_t sz = cli_arg_str_len(&base[i]);
+#if (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+void cli_ctx_print_trace(cli_ctx_t* ctx){
+    uint8_t named[(CLI_TRACE_MAX_ELEMENTS + 7) / 8] = { 0 };
+    
+    //Entries recorded during the dump are not part of it, each entry is copied under CLI_LOCK and printed with the lock released
+    CLI_LOCK();
+    uint32_t const total = cliTraceCount;
+    CLI_UNLOCK();
+    
+    uint32_t const count = ( (total < CLI_TRACE_SIZE) ? total : CLI_TRACE_SIZE );
+    uint32_t const first = total - count;
+    
+    BASE_PRINTLN("CLI_TRACE %u %u %u", (unsigned) CLI_TRACE_VERSION, (unsigned) total, (unsigned) count);
+    
+    for(uint32_t n = first; n != total; n++){
+        CLI_LOCK();
+        cliTrace_t const entry = cliTrace[n & (CLI_TRACE_SIZE - 1)];
+        CLI_UNLOCK();
         
-        int num_base = ( (cli_buff_element_is_hex(&base[i], sz) == true) ? 16 : 10 );
+        cliTrace_t const * const t = &entry;
+        uint16_t const id = t->id;
         
-        uint64_t num = strtol(&base[i], NULL, num_base);
+        //The name of an element is sent once, before the first entry using it. Its place is written before the entry, and never again
+        if(id != CLI_TRACE_NO_ID && !(named[id / 8] & (1 << (id % 8)))){
+            cliElement_t const * const e = cliTraceElements[id];
+            
+            named[id / 8] |= (uint8_t) (1 << (id % 8));
+            BASE_PRINTLN("E %u %s", (unsigned) id, ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) ) );
+        }
         
-        if(num > 255){
-            ERR_PRINTLN("Buffer argument error in byte number %u : Exceeded maximum value", pos);
-            err = false;
-            break;
+        //16 bytes little endian : start, parse, exec (uint32), element id (uint16), flags, amount of arguments (uint8)
+        uint8_t raw[16];
+        uint32_t const words[3] = { t->start, t->parse, t->exec };
+        
+        for(size_t w = 0; w < 3; w++){
+            for(size_t b = 0; b < 4; b++) raw[w * 4 + b] = (uint8_t) (words[w] >> (8 * b));
         }
         
-        if(pos >= buffLen - endString){
-            ERR_PRINTLN("Buffer received is too tiny, exiting...");
-            err = false;
-            break;
+        raw[12] = (uint8_t) id;
+        raw[13] = (uint8_t) (id >> 8);
+        raw[14] = t->flags;
+        raw[15] = t->args;
+        
+        char hex[sizeof(raw) * 2 + 1];
+        
+        for(size_t b = 0; b < sizeof(raw); b++){
+            hex[2 * b]     = "0123456789ABCDEF"[raw[b] >> 4];
+            hex[2 * b + 1] = "0123456789ABCDEF"[raw[b] & 0x0F];
         }
         
-        buff[pos++] = (uint8_t) num;
+        hex[sizeof(hex) - 1] = '\0';
         
-        i += sz;
+        BASE_PRINTLN("T %s", hex);
     }
     
-    if(isString && pos < buffLen) buff[pos++] = '\0';
-    
-    *res = pos;
-    
-    return err;
+    BASE_PRINTLN("CLI_TRACE_END");
 }
 
-static bool cli_get_buff_arg(size_t argNum, uint8_t buff[], size_t buffLen, size_t *res, bool isString){
-    if(currEl == NULL || argsStr == NULL) {
-        ERR_PRINTLN("Function usage is exculise to functions inside CLI");
-        return false;
-    }
-    
-    if(currEl->args == NULL) {
-        ERR_PRINTLN("Argument string is null");
-        return false;
-    }
-    
-    bool elipsisPresent = false;
-    int64_t len = cli_verify_args_str(currEl, &elipsisPresent);
-    
-    if(argNum >= len && !elipsisPresent) { 
-        ERR_PRINTLN("Argument index out of bounds");
-        return false;
-    }
-    
-    char* argBase = argsStr;
-    
-    for(size_t i = 0; i < argNum; i++)
-        argBase = cli_go_to_next_argument(argBase);
-        
-    if(argBase[0] == '\0') {
-        ERR_PRINTLN("Argument '%c' number %u not found in buffer", ( (isString) ? 's' : 'b' ), argNum );
-        return false;
-    }
-    
-    if( argNum < len && ( (!isString && currEl->args[argNum] != 'b') || (isString && currEl->args[argNum] != 's' ) ) && currEl->args[argNum] != '*' ) {
-        ERR_PRINTLN("Expected argument of type 's', but argument list says %c in index %u", currEl->args[argNum], argNum);
-        return false;
-    }
-    else if(argNum >= len || currEl->args[argNum] == '*'){
-        cli_verify_buffer(argBase, true);
-    }
-    
-    int32_t argLen = cli_arg_str_len(argBase);
-    
-    if(argLen == -1) { 
-        ERR_PRINTLN("Buffer in argument %u does not end", argNum);
-        return false;
-    }
+void cli_print_trace(void){
+    cli_ctx_print_trace(cliCurrCtx);
+}
+#endif
 
-    if(argBase[0] == '{') 
-        return cli_get_curly_braces(argBase, argLen, buff, buffLen, res, isString);
-    else if(argBase[0] == '"')
-        return cli_get_quotes(argBase, argLen, buff, buffLen, res, isString);
+#if (defined(CLI_TX_BUFFER_SIZE) && CLI_TX_BUFFER_SIZE > 0)
+void cli_ctx_set_flush(cli_ctx_t* ctx, cliFlush_t flush, void* arg){
+    if(ctx == NULL) return;
     
-    ERR_PRINTLN("Buffer does not begin with \" nor {");
-    return false;
+    ctx->flush = flush;
+    ctx->flushArg = arg;
 }
 
-/**********************************************
- * PRIVATE / PUBLIC FUNCTIONS
- *********************************************/
- 
-void cli_treat_command(char cliBuffer[], size_t maxLen){
-    if(maxLen == 0) return;
-    if(cliBuffer == NULL) return;
-    
-#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
-    if(cli_cmd_waiting_treatment == false) return;
+void cli_ctx_tx_done(cli_ctx_t* ctx){
+    if(ctx == NULL) return;
     
-    cli_cmd_waiting_treatment = false; 
-#endif //CLI_POLLING_EN
+    ctx->txTail += ctx->txBusy;
+    ctx->txBusy = 0;
     
-    cli_find_action(cliBuffer, maxLen);
+    cli_tx_kick(ctx);
+}
+
+void cli_ctx_flush(cli_ctx_t* ctx){
+    if(ctx == NULL) return;
     
-    len = 0;
-    memset(cliBuffer, 0, maxLen);
-    DBG_PRINT("Cmd treated, enter new command = ");
+    cli_tx_kick(ctx);
+}
+#endif
+
+cli_ctx_t* cli_get_default_ctx(void){
+    return &cliDefaultCtx;
 }
 
-/**********************************************
- * PUBLIC FUNCTIONS
- *********************************************/
+cli_ctx_t* cli_get_current_ctx(void){
+    return cliCurrCtx;
+}
 
 int64_t cli_get_int_argument(size_t argNum, bool *res){
     int64_t ret = 0;
-    bool success = cli_get_int_arg(argNum, &ret, false);
+    bool success = cli_get_int_arg(cliCurrCtx, argNum, &ret, false);
     
     if(res != NULL) *res = success;
     
@@ -865,7 +2613,7 @@ int64_t cli_get_int_argument(size_t argNum, bool *res){
 
 uint64_t cli_get_uint_argument(size_t argNum, bool *res){
     uint64_t ret = 0;
-    bool success = cli_get_int_arg(argNum, (int64_t*)&ret, true);
+    bool success = cli_get_int_arg(cliCurrCtx, argNum, (int64_t*)&ret, true);
     
     if(res != NULL) *res = success;
     
@@ -874,7 +2622,9 @@ uint64_t cli_get_uint_argument(size_t argNum, bool *res){
 
 #if (defined(CLI_FLOAT_EN) && CLI_FLOAT_EN == 1)
 float cli_get_float_argument(size_t argNum, bool *res){
-    if(currEl == NULL || argsStr == NULL) {
+    cli_ctx_t* const ctx = cliCurrCtx;
+    
+    if(ctx == NULL || ctx->currEl == NULL || ctx->argsStr == NULL) {
         ERR_PRINTF("Function usage is exculise to functions inside CLI");
         
         if(res != NULL) *res = 0;
@@ -882,54 +2632,45 @@ float cli_get_float_argument(size_t argNum, bool *res){
         return 0;
     }
     
-    if(currEl->args == NULL) {
-        ERR_PRINTF("Argument string is null");
+    size_t const len = ctx->spec.count;
+    
+    if(argNum >= len && !ctx->spec.elipsis) {
+        ERR_PRINTF("Argument index out of bounds");
         
         if(res != NULL) *res = 0;
         
         return 0;
     }
     
-    bool elipsisPresent = false;
-    int64_t len = cli_verify_args_str(currEl, &elipsisPresent);
-    
-    if(argNum >= len && !elipsisPresent) {
-        ERR_PRINTF("Argument index out of bounds");
+    if(argNum >= ctx->argsCount) {
+        ERR_PRINTF("Argument index %u not found in buffer", (unsigned) argNum);
         
         if(res != NULL) *res = 0;
         
         return 0;
     }
     
-    char* argBase = argsStr;
-    
-    for(size_t i = 0; i < argNum; i++)
-        argBase = cli_go_to_next_argument(argBase);
-        
-    if(argBase[0] == '\0') {
-        ERR_PRINTF("Argument index %u not found in buffer", argNum);
+    if( argNum < len && ctx->spec.types[argNum] != 'f' && ctx->spec.types[argNum] != '*') {
+        ERR_PRINTF("Expected argument of type 'f', but argument list says %c in index %u", ctx->spec.types[argNum], (unsigned) argNum);
         
         if(res != NULL) *res = 0;
         
         return 0;
     }
     
-    if( argNum < len && currEl->args[argNum] != 'f' && currEl->args[argNum] != '*') {
-        ERR_PRINTF("Expected argument of type 'f', but argument list says %c in index %u", currEl->args[argNum], argNum);
+    if( !(ctx->args[argNum].kind & CLI_ARG_KIND_FLOAT) ){
+        ERR_PRINTF("Argument index %u is not a valid float", (unsigned) argNum);
         
         if(res != NULL) *res = 0;
         
         return 0;
     }
-    else if(argNum >= len || currEl->args[argNum] == '*'){
-        if(!cli_verify_float(argBase, true)){
-            if(res != NULL) *res = 0;
-            
-            return 0;
-        }
-    }
     
-    float ret = strtof(argBase, NULL);
+    //Decimal integers are valid floats too, but were stored as integers
+    float ret = ctx->args[argNum].val.f;
+    
+    if(ctx->args[argNum].kind & CLI_ARG_KIND_INT) ret = (float) ctx->args[argNum].val.i;
+    else if(ctx->args[argNum].kind & CLI_ARG_KIND_UINT) ret = (float) ctx->args[argNum].val.u;
     
     if(res != NULL) *res = 1;
     
@@ -939,7 +2680,7 @@ float cli_get_float_argument(size_t argNum, bool *res){
 
 size_t cli_get_buffer_argument(size_t argNum, uint8_t buff[], size_t buffLen, bool* res){
     size_t bRead = 0;
-    bool ret = cli_get_buff_arg(argNum, buff, buffLen, &bRead, false);
+    bool ret = cli_get_buff_arg(cliCurrCtx, argNum, buff, buffLen, &bRead, false);
     
     if(res != NULL) *res = ret;
     
@@ -948,7 +2689,7 @@ size_t cli_get_buffer_argument(size_t argNum, uint8_t buff[], size_t buffLen, bo
 
 size_t cli_get_buffer_argument_big_endian(size_t argNum, uint8_t buff[], size_t buffLen, bool* res){
     size_t bRead = 0;
-    bool ret = cli_get_buff_arg(argNum, buff, buffLen, &bRead, false);
+    bool ret = cli_get_buff_arg(cliCurrCtx, argNum, buff, buffLen, &bRead, false);
     
     uint8_t aux = 0;
     
@@ -966,48 +2707,131 @@ size_t cli_get_buffer_argument_big_endian(size_t argNum, uint8_t buff[], size_t
 
 size_t cli_get_string_argument(size_t argNum, uint8_t buff[], size_t buffLen, bool* res){
     size_t bRead = 0;
-    bool ret = cli_get_buff_arg(argNum, buff, buffLen, &bRead, true);
+    bool ret = cli_get_buff_arg(cliCurrCtx, argNum, buff, buffLen, &bRead, true);
     
     if(res != NULL) *res = ret;
     
     return bRead;
 }
 
-cli_status_e cli_insert_char(char cliBuffer[], size_t maxLen, char const c){
-    if(maxLen == 0) return CLI_ERR;
-    if(cliBuffer == NULL) return CLI_ERR;
+cli_status_e cli_ctx_insert_char(cli_ctx_t* ctx, char const c){
+    if(ctx == NULL) return CLI_ERR;
+    if(ctx->size == 0) return CLI_ERR;
+    if(ctx->buffer == NULL) return CLI_ERR;
     
-#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
-    if(cli_cmd_waiting_treatment){
-        ERR_PRINTLN("Command waiting for treatment");
-        return CLI_WAITING_TREATMENT;
-    }
-#endif //CLI_POLLING_EN
-
     if(c == '\r') return CLI_CONTINUE;
 
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+    if(c == '\n') return cli_rx_end_line(ctx);
+    
+    cli_rx_push(ctx, &c, 1);
+    
+    return CLI_CONTINUE;
+#else
     if(c != '\n'){
-        cliBuffer[((len++)%maxLen)] = c;
+        ctx->buffer[((ctx->len++)%ctx->size)] = c;
+        
+        #if (defined(CLI_INCREMENTAL_EN) && CLI_INCREMENTAL_EN == 1)
+        //The last byte is kept for the terminator, the line is too big once it is written
+        if(ctx->len >= ctx->size){
+            ctx->incState = CLI_INC_TOO_BIG;
+        }
+        
+        else{
+            ctx->incMuted = true;
+            cli_inc_push(ctx, ctx->len - 1);
+            ctx->incMuted = false;
+        }
+        #endif
+        
         return CLI_CONTINUE;
     }
     
-    if(len >= maxLen){
-        len = 0;
-        memset(cliBuffer, 0, maxLen);
+    if(ctx->len >= ctx->size){
+        ctx->len = 0;
+        ctx->buffer[0] = '\0';
+        
+        #if (defined(CLI_INCREMENTAL_EN) && CLI_INCREMENTAL_EN == 1)
+        cli_inc_reset(ctx);
+        #endif
+        
         ERR_PRINT("COMMAND TOO LARGE! Enter new command = ");
         return CLI_TOO_BIG;
     }
     
-    cliBuffer[len] = '\0';
-    DBG_PRINTLN("Cmd rcv = '%s'", cliBuffer);
+    ctx->buffer[ctx->len] = '\0';
+    DBG_PRINTLN("Cmd rcv = '%s'", ctx->buffer);
     
-#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 0)
-    cli_treat_command(cliBuffer, maxLen);
+    #if (defined(CLI_INCREMENTAL_EN) && CLI_INCREMENTAL_EN == 1)
+    ctx->incMuted = true;
+    cli_inc_end(ctx);
+    ctx->incMuted = false;
+    #endif
+    
+    cli_ctx_treat_command(ctx);
     return CLI_COMMAND_RCV;
+#endif //CLI_POLLING_EN
+}
+
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+void cli_ctx_get_rx_status(cli_ctx_t* ctx, cliRxStatus_t* status){
+    if(ctx == NULL || status == NULL) return;
+    
+    size_t const tail = ctx->rxTail;
+    size_t const linesOut = ctx->rxLinesOut;
+    
+    status->commands = ctx->rxLinesIn - linesOut;
+    status->depth = CLI_RX_QUEUE_DEPTH;
+    status->bytes = ctx->rxHead - tail;
+    status->size = CLI_RX_SIZE(ctx);
+}
+
+void cli_get_rx_status(cliRxStatus_t* status){
+    cli_ctx_get_rx_status(&cliDefaultCtx, status);
+}
+#endif //CLI_POLLING_EN
+
+cli_status_e cli_insert_char(char cliBuffer[], size_t maxLen, char const c){
+    cli_set_default_buffer(cliBuffer, maxLen);
+    
+    return cli_ctx_insert_char(&cliDefaultCtx, c);
+}
+
+size_t cli_ctx_insert_chars(cli_ctx_t* ctx, char const buf[], size_t n){
+    if(ctx == NULL || buf == NULL) return 0;
+    if(ctx->size == 0) return 0;
+    if(ctx->buffer == NULL) return 0;
+    
+    size_t commands = 0;
+
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+    size_t i = 0;
+    
+    while(i < n){
+        size_t const end = i + cli_find_line_end(&buf[i], n - i);
+        
+        //Characters up to the line end are copied at once
+        cli_rx_push(ctx, &buf[i], end - i);
+        
+        if(end == n) break;
+        
+        if(buf[end] == '\n' && cli_rx_end_line(ctx) == CLI_WAITING_TREATMENT) commands++;
+        
+        i = end + 1;
+    }
 #else
-    cli_cmd_waiting_treatment = true;
-    return CLI_WAITING_TREATMENT;
+    for(size_t i = 0; i < n; i++){
+        if(cli_ctx_insert_char(ctx, buf[i]) == CLI_COMMAND_RCV) commands++;
+    }
 #endif //CLI_POLLING_EN
+
+    return commands;
+}
+
+size_t cli_insert_chars(char cliBuffer[], size_t maxLen, char const buf[], size_t n){
+    cli_set_default_buffer(cliBuffer, maxLen);
+    
+    return cli_ctx_insert_chars(&cliDefaultCtx, buf, n);
 }
 
 __attribute__((weak)) void cli_printf(char const * const str, ...){
@@ -1018,12 +2842,108 @@ __attribute__((weak)) void cli_printf(char const * const str, ...){
 
 }
 
+#if (defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+__attribute__((weak)) void cli_write(char const data[], size_t len){
+    cli_printf("%.*s", (int) len, data);
+}
+#endif
+
 #else
 
 /**********************************************
  * PUBLIC FUNCTIONS
  *********************************************/
  
+void cli_ctx_init(cli_ctx_t* ctx, char buffer[], size_t size){
+    (void)ctx;
+    (void)buffer;
+    (void)size;
+}
+
+void cli_ctx_set_output(cli_ctx_t* ctx, cliPrint_t print, void* arg){
+    (void)ctx;
+    (void)print;
+    (void)arg;
+}
+
+void cli_ctx_printf(cli_ctx_t* ctx, char const * const str, ...){}
+
+#if (defined(CLI_STATS_EN) && CLI_STATS_EN == 1)
+void cli_ctx_print_stats(cli_ctx_t* ctx){
+    (void)ctx;
+}
+
+void cli_print_stats(void){}
+#endif
+
+#if (defined(CLI_REGISTRY_EN) && CLI_REGISTRY_EN == 1)
+void cli_registry_init(void){}
+#endif
+
+#if (defined(CLI_TYPED_EN) && CLI_TYPED_EN == 1)
+void cli_typed_action(void){}
+#endif
+
+#if (defined(CLI_TRACE_EN) && CLI_TRACE_EN == 1)
+void cli_ctx_print_trace(cli_ctx_t* ctx){
+    (void)ctx;
+}
+
+void cli_print_trace(void){}
+#endif
+
+#if (defined(CLI_TX_BUFFER_SIZE) && CLI_TX_BUFFER_SIZE > 0)
+void cli_ctx_set_flush(cli_ctx_t* ctx, cliFlush_t flush, void* arg){
+    (void)ctx;
+    (void)flush;
+    (void)arg;
+}
+
+void cli_ctx_tx_done(cli_ctx_t* ctx){
+    (void)ctx;
+}
+
+void cli_ctx_flush(cli_ctx_t* ctx){
+    (void)ctx;
+}
+#endif
+
+cli_ctx_t* cli_get_default_ctx(void){
+    return NULL;
+}
+
+cli_ctx_t* cli_get_current_ctx(void){
+    return NULL;
+}
+
+cli_status_e cli_ctx_insert_char(cli_ctx_t* ctx, char const c){
+    return CLI_DISABLED;
+}
+
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+void cli_ctx_treat_command(cli_ctx_t* ctx){
+    (void)ctx;
+}
+#endif //CLI_POLLING_EN
+
+size_t cli_ctx_insert_chars(cli_ctx_t* ctx, char const buf[], size_t n){
+    return 0;
+}
+
+size_t cli_insert_chars(char cliBuffer[], size_t maxLen, char const buf[], size_t n){
+    return 0;
+}
+
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+void cli_ctx_get_rx_status(cli_ctx_t* ctx, cliRxStatus_t* status){
+    if(status != NULL) memset(status, 0, sizeof(cliRxStatus_t));
+}
+
+void cli_get_rx_status(cliRxStatus_t* status){
+    if(status != NULL) memset(status, 0, sizeof(cliRxStatus_t));
+}
+#endif //CLI_POLLING_EN
+
 int64_t cli_get_int_argument(size_t argNum, bool *res){
     return 0;
 }
@@ -1054,11 +2974,17 @@ cli_status_e cli_insert_char(char cliBuffer[], size_t maxLen, char const c){
     return CLI_DISABLED;
 }
 
+#if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
 void cli_treat_command(char cliBuffer[], size_t maxLen){
     (void)cliBuffer;
     (void)maxLen;
 }
+#endif //CLI_POLLING_EN
 
 __attribute__((weak)) void cli_printf(char const * const str, ...){}
 
+#if (defined(CLI_FORMATTER_EN) && CLI_FORMATTER_EN == 1)
+__attribute__((weak)) void cli_write(char const data[], size_t len){}
+#endif
+
 #endif //CLI_EN
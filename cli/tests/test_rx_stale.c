@@ -0,0 +1,192 @@
+/*
+ * test_rx_stale.c
+ *
+ * Host regression test of the reception : the command buffer (or the reception ring) is not cleared between commands, so the bytes
+ * of a longer previous command are still behind the terminator of the next one. They must never be read as arguments. Each long
+ * command is followed by shorter ones (complete, with fewer arguments, with a string or a buffer not closed), sent character by
+ * character and at once. Build and run it in each reception mode :
+ *
+ *     gcc -Icli/inc cli/tests/test_rx_stale.c cli/src/cli_internal.c -o test_rx_stale && ./test_rx_stale
+ *     gcc -Icli/inc -DCLI_ZERO_COPY_EN=1 cli/tests/test_rx_stale.c cli/src/cli_internal.c -o test_rx_stale && ./test_rx_stale
+ *     gcc -Icli/inc -DCLI_POLLING_EN=0 cli/tests/test_rx_stale.c cli/src/cli_internal.c -o test_rx_stale && ./test_rx_stale
+ *     gcc -Icli/inc -DCLI_POLLING_EN=0 -DCLI_INCREMENTAL_EN=1 cli/tests/test_rx_stale.c cli/src/cli_internal.c -o test_rx_stale && ./test_rx_stale
+ *
+ * The exit code is the amount of failed checks.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cli.h"
+
+/**********************************************
+ * DEFINES
+ *********************************************/
+
+//Power of 2 for the zero copy mode, the long commands nearly fill it
+#define TEST_BUFFER_SIZE    64
+
+#define TEST_CHECK(cond)                                                                                                                \
+    do{                                                                                                                                 \
+        if(!(cond)){                                                                                                                    \
+            printf("FAILED line %d after '%s' (%s) : %s\n", __LINE__, lastCmd, ( (lastAtOnce) ? "at once" : "by character" ), #cond);    \
+            failures++;                                                                                                                 \
+        }                                                                                                                               \
+    }while(0)
+
+/**********************************************
+ * PRIVATE VARIABLES
+ *********************************************/
+
+static char cliBuff[TEST_BUFFER_SIZE];
+
+static char const* lastCmd = "";
+static bool lastAtOnce = false;
+static int failures = 0;
+
+//Arguments received by the last action called
+static unsigned calls = 0;
+static size_t numCount = 0;
+static uint64_t numLast = 0;
+static char strArg[TEST_BUFFER_SIZE];
+static uint8_t buf[TEST_BUFFER_SIZE];
+static size_t bufLen = 0;
+
+/**********************************************
+ * PRIVATE FUNCTIONS
+ *********************************************/
+
+static void numFn(void){
+    bool res = true;
+
+    calls++;
+    numCount = 0;
+
+    while(true){
+        uint64_t const val = cli_get_uint_argument(numCount, &res);
+
+        if(!res) break;
+
+        numLast = val;
+        numCount++;
+    }
+}
+
+static void strFn(void){
+    calls++;
+    memset(strArg, 0, sizeof(strArg));
+    cli_get_string_argument(0, (uint8_t*) strArg, sizeof(strArg), NULL);
+}
+
+static void bufFn(void){
+    calls++;
+    bufLen = cli_get_buffer_argument(0, buf, sizeof(buf), NULL);
+}
+
+//Sends one command, at once or character by character, and treats it
+static void test_send(char const* cmd, bool atOnce){
+    lastCmd = cmd;
+    lastAtOnce = atOnce;
+
+    if(atOnce){
+        cli_insert_chars(cliBuff, sizeof(cliBuff), cmd, strlen(cmd));
+    }
+
+    else{
+        for(size_t i = 0; cmd[i] != '\0'; i++) cli_insert_char(cliBuff, sizeof(cliBuff), cmd[i]);
+    }
+
+    cli_insert_char(cliBuff, sizeof(cliBuff), '\n');
+
+    #if (defined(CLI_POLLING_EN) && CLI_POLLING_EN == 1)
+    cli_treat_command(cliBuff, sizeof(cliBuff));
+    #endif
+}
+
+static void test_numbers(bool atOnce){
+    test_send("num 1111 2222 3333 4444 5555 6666 7777 8888 9999 1010 12", atOnce);
+    TEST_CHECK(numCount == 11 && numLast == 12);
+
+    test_send("num 5", atOnce);
+    TEST_CHECK(numCount == 1 && numLast == 5);
+
+    //At least one number is needed : the numbers of the previous commands are still behind the terminator
+    unsigned const before = calls;
+
+    test_send("num", atOnce);
+    TEST_CHECK(calls == before);
+}
+
+static void test_strings(bool atOnce){
+    test_send("str \"abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOP\"", atOnce);
+    TEST_CHECK(strcmp(strArg, "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOP") == 0);
+
+    test_send("str \"ab\"", atOnce);
+    TEST_CHECK(strcmp(strArg, "ab") == 0);
+
+    //Not closed : the quote of the previous command is still behind the terminator
+    unsigned const before = calls;
+
+    test_send("str \"ab", atOnce);
+    TEST_CHECK(calls == before);
+
+    test_send("str", atOnce);
+    TEST_CHECK(calls == before);
+}
+
+static void test_buffers(bool atOnce){
+    test_send("buf { 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F 1A 1B }", atOnce);
+    TEST_CHECK(bufLen == 17 && buf[16] == 0x1B);
+
+    test_send("buf {01 02}", atOnce);
+    TEST_CHECK(bufLen == 2 && buf[0] == 0x01 && buf[1] == 0x02);
+
+    //Not closed : the brace of the previous command is still behind the terminator
+    unsigned const before = calls;
+
+    test_send("buf {01 02", atOnce);
+    TEST_CHECK(calls == before);
+
+    test_send("buf #0A0B0C0D0E0F101112131415161718191A1B1C1D1E1F20212223", atOnce);
+    TEST_CHECK(bufLen == 26 && buf[25] == 0x23);
+
+    test_send("buf #0A0B", atOnce);
+    TEST_CHECK(bufLen == 2 && buf[1] == 0x0B);
+}
+
+/**********************************************
+ * GLOBAL VARIABLES
+ *********************************************/
+
+cliElement_t cliMainMenu[] = {
+    cliActionElement("num",     numFn,      "u...",     "Receives numbers"  ),
+    cliActionElement("str",     strFn,      "s",        "Receives a string" ),
+    cliActionElement("buf",     bufFn,      "b",        "Receives a buffer" ),
+    cliMenuTerminator()
+};
+
+/**********************************************
+ * PUBLIC FUNCTIONS
+ *********************************************/
+
+//Errors of the refused commands are expected, they are not printed
+void cli_printf(char const * const str, ...){
+    (void) str;
+}
+
+int main(void){
+    printf("CLI_POLLING_EN = %d, CLI_ZERO_COPY_EN = %d, CLI_INCREMENTAL_EN = %d\n", CLI_POLLING_EN, CLI_ZERO_COPY_EN, CLI_INCREMENTAL_EN);
+
+    for(int atOnce = 0; atOnce < 2; atOnce++){
+        //Several laps, so the commands are also received at every place of the ring
+        for(int lap = 0; lap < 8; lap++){
+            test_numbers(atOnce);
+            test_strings(atOnce);
+            test_buffers(atOnce);
+        }
+    }
+
+    printf("%s (%d failed checks)\n", ( (failures == 0) ? "PASSED" : "FAILED" ), failures);
+
+    return failures;
+}
@@ -0,0 +1,238 @@
+/*
+ * cli_help_gen.c
+ *
+ * Host tool that walks cliMainMenu and prints the C source of the help used when CLI_HELP_PREBUILT_EN is 1 : the text of every
+ * menu listing and of every action usage, rendered once on the host by the CLI itself.
+ *
+ * Build it on the host with the same menu sources and configuration as the firmware (cli_internal.c is included by the tool, do not
+ * link it) :
+ *
+ *     gcc -Icli/inc cli/tools/cli_help_gen.c <menu sources> -o cli_help_gen
+ *     ./cli_help_gen > cli_help.c
+ *
+ * Then compile cli_help.c with the firmware and set CLI_HELP_PREBUILT_EN to 1. Sub menus are numbered in depth first order, starting
+ * with the main menu (index 0), the same numbering as cli_trie_gen.
+ */
+
+//The rendering code of the CLI is included so the generated text is exactly what the firmware would print
+#undef CLI_HELP_PREBUILT_EN
+#define CLI_HELP_PREBUILT_EN 0
+#undef CLI_MENU_PRINT_ENABLE
+#define CLI_MENU_PRINT_ENABLE 1
+#undef CLI_ERROR_PRINT_ENABLE
+#define CLI_ERROR_PRINT_ENABLE 0
+#undef CLI_DEBUG_ENABLE
+#define CLI_DEBUG_ENABLE 0
+#undef CLI_FORMATTER_EN
+#define CLI_FORMATTER_EN 0
+#undef CLI_TX_BUFFER_SIZE
+#define CLI_TX_BUFFER_SIZE 0
+
+#include "../src/cli_internal.c"
+
+/**********************************************
+ * DEFINES
+ *********************************************/
+
+#define GEN_MAX_MENUS       1024
+#define GEN_MAX_ELEMENTS    4096
+#define GEN_MAX_DEPTH       32
+
+/**********************************************
+ * PRIVATE VARIABLES
+ *********************************************/
+
+static cli_ctx_t genCtx;
+static char genBuffer[8];
+
+static char* capture = NULL;
+static size_t captureLen = 0;
+static size_t captureSize = 0;
+
+static char* menuText[GEN_MAX_MENUS];
+static char const* menuName[GEN_MAX_MENUS];
+static size_t menuFirst[GEN_MAX_MENUS];
+static size_t menuCount = 0;
+
+static cliHelpElement_t elements[GEN_MAX_ELEMENTS];
+static char* elementUsage[GEN_MAX_ELEMENTS];
+static char const* elementName[GEN_MAX_ELEMENTS];
+static size_t elementsCount = 0;
+
+static size_t textBytes = 0;
+
+/**********************************************
+ * PRIVATE FUNCTIONS
+ *********************************************/
+
+static void gen_capture(void* arg, char const * const str, va_list args){
+    (void) arg;
+
+    va_list copy;
+    va_copy(copy, args);
+    int const len = vsnprintf(NULL, 0, str, copy);
+    va_end(copy);
+
+    if(len <= 0) return;
+
+    if(captureLen + (size_t) len + 1 > captureSize){
+        captureSize = (captureLen + (size_t) len + 1) * 2;
+        capture = realloc(capture, captureSize);
+
+        if(capture == NULL){
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+
+    vsnprintf(&capture[captureLen], (size_t) len + 1, str, args);
+    captureLen += (size_t) len;
+}
+
+//Returns what was printed since the last call, NULL if nothing was
+static char* gen_take_capture(void){
+    if(captureLen == 0) return NULL;
+
+    //Lengths are generated on 16 bits
+    if(captureLen > UINT16_MAX){
+        fprintf(stderr, "Help text of %u bytes, longer than %u\n", (unsigned) captureLen, (unsigned) UINT16_MAX);
+        exit(1);
+    }
+
+    char* const text = capture;
+
+    textBytes += captureLen + 1;
+
+    capture = NULL;
+    captureLen = 0;
+    captureSize = 0;
+
+    return text;
+}
+
+static void gen_build_menu(cliElement_t const * const menu, size_t depth){
+    if(depth > GEN_MAX_DEPTH){
+        fprintf(stderr, "Menu tree deeper than %d, is a sub menu referencing itself ?\n", GEN_MAX_DEPTH);
+        exit(1);
+    }
+
+    if(menuCount >= GEN_MAX_MENUS){
+        fprintf(stderr, "Too many menus, increase GEN_MAX_MENUS\n");
+        exit(1);
+    }
+
+    cli_ctx_t* const ctx = &genCtx;
+    size_t const m = menuCount++;
+
+    menuName[m] = ( (CLI_EL_NAME(menu) == NULL) ? "NULL_NAME" : CLI_EL_NAME(menu) );
+
+    MENU_PRINTF("Menu '%s' - %s\r\n", CLI_EL_NAME(menu), CLI_EL_DESC(menu));
+    cli_print_menu(ctx, menu);
+    menuText[m] = gen_take_capture();
+
+    size_t count = 0;
+
+    while(!cli_is_terminator(&CLI_EL_SUB(menu)[count])) count++;
+
+    if(elementsCount + count > GEN_MAX_ELEMENTS){
+        fprintf(stderr, "Too many elements, increase GEN_MAX_ELEMENTS\n");
+        exit(1);
+    }
+
+    //Elements of a menu are contiguous, the sub menus are numbered (depth first) while walking
+    size_t const first = elementsCount;
+    menuFirst[m] = first;
+    elementsCount += count;
+
+    for(size_t i = 0; i < count; i++){
+        cliElement_t const * const e = &CLI_EL_SUB(menu)[i];
+
+        elements[first + i].subMenu = CLI_HELP_NONE;
+        elementUsage[first + i] = NULL;
+        elementName[first + i] = ( (CLI_EL_NAME(e) == NULL) ? "NULL_NAME" : CLI_EL_NAME(e) );
+
+        if(cli_is_sub_menu(e)){
+            elements[first + i].subMenu = (uint16_t) menuCount;
+            gen_build_menu(e, depth + 1);
+        }
+
+        //An invalid specification keeps the usage to NULL, the firmware then reports the error itself
+        else if(cli_is_action(e) && cli_get_args_spec(ctx, e) != NULL){
+            cli_print_action(ctx, e);
+            elementUsage[first + i] = gen_take_capture();
+        }
+    }
+}
+
+static void gen_print_string(char const* str){
+    if(str == NULL){
+        printf("NULL");
+        return;
+    }
+
+    printf("\"");
+
+    for(size_t i = 0; str[i] != '\0'; i++){
+        char const c = str[i];
+
+        if(c == '\r')                       printf("\\r");
+        else if(c == '\n')                  printf( (str[i + 1] == '\0') ? "\\n" : "\\n\"\n        \"" );
+        else if(c == '"' || c == '\\')      printf("\\%c", c);
+        else if(isprint((unsigned char) c)) printf("%c", c);
+        else                                printf("\\%03o", (unsigned char) c);
+    }
+
+    printf("\"");
+}
+
+/**********************************************
+ * PUBLIC FUNCTIONS
+ *********************************************/
+
+int main(void){
+    cli_ctx_init(&genCtx, genBuffer, sizeof(genBuffer));
+    cli_ctx_set_output(&genCtx, gen_capture, NULL);
+
+    gen_build_menu(CLI_MAIN_ELEMENT, 0);
+
+    printf("/*\n * cli_help.c\n *\n *  Generated by cli_help_gen, do not edit. %u menus, %u elements, %u bytes of text\n */\n\n",
+           (unsigned) menuCount, (unsigned) elementsCount, (unsigned) textBytes);
+
+    printf("#include \"cli.h\"\n\n");
+    printf("#if (defined(CLI_EN) && CLI_EN == 1) && (defined(CLI_HELP_PREBUILT_EN) && CLI_HELP_PREBUILT_EN == 1)\n\n");
+
+    printf("const uint16_t cliHelpMenuCount = %u;\n\n", (unsigned) menuCount);
+
+    printf("const char* const cliHelpMenu[] = {\n");
+    for(size_t m = 0; m < menuCount; m++){
+        printf("    //%s\n    ", menuName[m]);
+        gen_print_string(menuText[m]);
+        printf(",\n");
+    }
+    printf("};\n\n");
+
+    printf("const uint16_t cliHelpMenuLen[] = {\n");
+    for(size_t m = 0; m < menuCount; m++){
+        printf("    %u,    //%s\n", (unsigned) ( (menuText[m] == NULL) ? 0 : strlen(menuText[m]) ), menuName[m]);
+    }
+    printf("};\n\n");
+
+    printf("const uint16_t cliHelpMenuFirst[] = {\n");
+    for(size_t m = 0; m < menuCount; m++){
+        printf("    %u,    //%s\n", (unsigned) menuFirst[m], menuName[m]);
+    }
+    printf("    %u\n};\n\n", (unsigned) elementsCount);
+
+    printf("const cliHelpElement_t cliHelpElements[] = {\n");
+    for(size_t i = 0; i < elementsCount; i++){
+        printf("    /* %4u %s */ { 0x%04X, %u, ", (unsigned) i, elementName[i], elements[i].subMenu,
+               (unsigned) ( (elementUsage[i] == NULL) ? 0 : strlen(elementUsage[i]) ));
+        gen_print_string(elementUsage[i]);
+        printf(" },\n");
+    }
+    printf("};\n\n");
+
+    printf("#endif\n");
+
+    return 0;
+}
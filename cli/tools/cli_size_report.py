@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+#
+# cli_size_report.py
+#
+# Compares the memory used by the menu tables in the classic layout (cliElement_t arrays) and in the compact layout (CLI_COMPACT_EN,
+# cli_compact.h). The same synthetic tree is written in both forms, compiled with the given compiler, and the sections of the two objects
+# are summed :
+#
+#     ./cli_size_report.py                                          (host gcc, 500 elements)
+#     ./cli_size_report.py --cc arm-none-eabi-gcc --cflags "-Os -mcpu=cortex-m4 -mthumb" --elements 1000
+#
+# Only the tables are measured, the actions are external functions. RAM is the initialized data (copied from flash at boot) and the bss,
+# flash is the code, the constants and the initial values of the data.
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+INC = os.path.normpath(os.path.join(HERE, "..", "inc"))
+
+SPECS = ["u8", "ii", "s", "b", "u16u16", "i32...", "*", ""]
+
+
+def build_tree(elements, width):
+    """Returns the sub menus, each one being a list of (fn, name, args, desc) actions, for 'elements' elements in total"""
+    menus = []
+    left = elements
+    n = 0
+
+    while left > 0:
+        left -= 1   # the sub menu element itself
+        count = min(width, left)
+        menus.append([("cli_fn_%04u" % (n + i), "action_%04u" % (n + i), SPECS[(n + i) % len(SPECS)],
+                       "Description of the action number %u" % (n + i)) for i in range(count)])
+        n += count
+        left -= count
+
+    return menus
+
+
+def classic_source(menus):
+    out = ['#include "cli.h"', ""]
+
+    for menu in menus:
+        for fn, _, _, _ in menu:
+            out.append("extern void %s(void);" % fn)
+
+    out.append("")
+
+    for m, menu in enumerate(menus):
+        out.append("cliElement_t cli_menu_%04u[] = {" % m)
+        for fn, name, args, desc in menu:
+            out.append('    cliActionElement("%s", %s, "%s", "%s"),' % (name, fn, args, desc))
+        out.append("    cliMenuTerminator()")
+        out.append("};")
+        out.append("")
+
+    out.append("cliElement_t cliMainMenu[] = {")
+    for m in range(len(menus)):
+        out.append('    cliSubMenuElement("menu_%04u", cli_menu_%04u, "Description of the menu number %u"),' % (m, m, m))
+    out.append("    cliMenuTerminator()")
+    out.append("};")
+
+    return "\n".join(out) + "\n"
+
+
+def compact_source(menus):
+    out = ['#include "cli.h"', ""]
+
+    for menu in menus:
+        for fn, _, _, _ in menu:
+            out.append("extern void %s(void);" % fn)
+
+    out.append("")
+    out.append("#define CLI_COMPACT_MENUS(MENU) \\")
+    out.append("    MENU(main) \\")
+    for m in range(len(menus)):
+        out.append("    MENU(cli_menu_%04u) \\" % m)
+    out.append("")
+
+    out.append("#define CLI_COMPACT_MENU_main(SUB, ACTION) \\")
+    for m in range(len(menus)):
+        out.append('    SUB(cli_menu_%04u, "menu_%04u", "Description of the menu number %u") \\' % (m, m, m))
+    out.append("")
+
+    for m, menu in enumerate(menus):
+        out.append("#define CLI_COMPACT_MENU_cli_menu_%04u(SUB, ACTION) \\" % m)
+        for fn, name, args, desc in menu:
+            out.append('    ACTION(%s, "%s", "%s", "%s") \\' % (fn, name, args, desc))
+        out.append("")
+
+    out.append('#include "cli_compact.h"')
+
+    return "\n".join(out) + "\n"
+
+
+def sections(args, src, defines, workdir, tag):
+    c = os.path.join(workdir, tag + ".c")
+    o = os.path.join(workdir, tag + ".o")
+
+    with open(c, "w") as f:
+        f.write(src)
+
+    cmd = [args.cc] + args.cflags.split() + defines + ["-I" + INC, "-c", c, "-o", o]
+
+    if subprocess.call(cmd) != 0:
+        sys.exit("Compilation failed : " + " ".join(cmd))
+
+    out = subprocess.check_output([args.size, "-A", o], universal_newlines=True)
+    res = {}
+
+    for line in out.splitlines():
+        words = line.split()
+
+        if len(words) >= 2 and words[0].startswith(".") and words[1].isdigit():
+            res[words[0]] = int(words[1])
+
+    return res
+
+
+def totals(secs):
+    ram = 0
+    flash = 0
+
+    for name, size in secs.items():
+        if name.startswith((".comment", ".note", ".debug", ".eh_frame", ".group", ".ARM.attributes")):
+            continue
+
+        # .data.rel.ro is only written by the loader of hosted platforms, it is constant for the firmware
+        writable = name.startswith(".data") and not name.startswith(".data.rel.ro")
+
+        if name.startswith(".bss"):
+            ram += size
+        elif writable:
+            ram += size
+            flash += size
+        else:
+            flash += size
+
+    return ram, flash
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compares the size of the classic and compact menu tables")
+    parser.add_argument("--elements", type=int, default=500, help="elements in the tree, sub menus included (default 500)")
+    parser.add_argument("--width", type=int, default=49, help="actions per sub menu (default 49)")
+    parser.add_argument("--cc", default="gcc", help="C compiler (default gcc)")
+    parser.add_argument("--size", default=None, help="size tool (default: the one next to the compiler)")
+    parser.add_argument("--cflags", default="-Os -fno-pic", help="compiler flags (default -Os -fno-pic)")
+    args = parser.parse_args()
+
+    if args.size is None:
+        args.size = args.cc[:-3] + "size" if args.cc.endswith("gcc") else "size"
+
+    menus = build_tree(args.elements, max(1, args.width))
+    count = len(menus) + sum(len(m) for m in menus)
+
+    with tempfile.TemporaryDirectory() as workdir:
+        classic = totals(sections(args, classic_source(menus), [], workdir, "classic"))
+        compact = totals(sections(args, compact_source(menus), ["-DCLI_COMPACT_EN=1"], workdir, "compact"))
+
+    print("%u elements (%u sub menus), %s %s" % (count, len(menus), args.cc, args.cflags))
+    print("")
+    print("%-10s %10s %10s %14s" % ("layout", "RAM", "flash", "RAM / element"))
+
+    for name, (ram, flash) in (("classic", classic), ("compact", compact)):
+        print("%-10s %10u %10u %14.1f" % (name, ram, flash, ram / float(count)))
+
+    print("")
+    print("RAM saved   : %d bytes" % (classic[0] - compact[0]))
+    print("flash saved : %d bytes" % (classic[1] - compact[1]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+#
+# cli_trace_decode.py
+#
+# Host decoder of the trace dumped by the cli_trace command (CLI_TRACE_EN). Reads a console capture containing one or more dumps
+# (other text is ignored) and prints one line per action execution, oldest first :
+#
+#     ./cli_trace_decode.py capture.txt
+#     ./cli_trace_decode.py --hz 64000000 --csv capture.txt > trace.csv
+#
+# Times are in CLI_STATS_TIMER units, or in micro seconds when the timer frequency is given with --hz.
+
+import argparse
+import struct
+import sys
+
+TRACE_VERSION = 1
+
+# 16 bytes little endian : start, parse, exec (uint32), element id (uint16), flags, amount of arguments (uint8)
+ENTRY = struct.Struct("<IIIHBB")
+FLAG_VERIFIED = 1 << 0
+
+
+def parse_dumps(lines):
+    """Yields (total, entries) for each complete dump, entries being (seq, start, parse, exec, name, verified, args)"""
+    dump = None
+
+    for line in lines:
+        words = line.strip().split(" ", 2)
+
+        if words[0] == "CLI_TRACE":
+            version, total, count = (int(w) for w in line.split()[1:4])
+
+            if version != TRACE_VERSION:
+                sys.exit("Trace version %u not supported (expected %u)" % (version, TRACE_VERSION))
+
+            dump = {"total": total, "first": total - count, "names": {}, "entries": []}
+
+        elif dump is None:
+            continue
+
+        elif words[0] == "E" and len(words) == 3:
+            dump["names"][int(words[1])] = words[2]
+
+        elif words[0] == "T" and len(words) == 2:
+            start, parse, exe, el, flags, args = ENTRY.unpack(bytes.fromhex(words[1]))
+            seq = dump["first"] + len(dump["entries"])
+            name = dump["names"].get(el, "element_%u" % el)
+
+            dump["entries"].append((seq, start, parse, exe, name, bool(flags & FLAG_VERIFIED), args))
+
+        elif words[0] == "CLI_TRACE_END":
+            yield dump["total"], dump["entries"]
+            dump = None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decodes the dumps of the cli_trace command")
+    parser.add_argument("capture", nargs="?", help="console capture (stdin if omitted)")
+    parser.add_argument("--hz", type=float, default=None, help="CLI_STATS_TIMER frequency, prints micro seconds instead of ticks")
+    parser.add_argument("--csv", action="store_true", help="CSV output")
+    args = parser.parse_args()
+
+    src = open(args.capture, errors="replace") if args.capture else sys.stdin
+
+    with src:
+        dumps = list(parse_dumps(src))
+
+    if not dumps:
+        sys.exit("No complete trace dump found")
+
+    def conv(ticks):
+        return ticks if args.hz is None else ticks * 1e6 / args.hz
+
+    unit = "ticks" if args.hz is None else "us"
+
+    if args.csv:
+        print("seq,start,since_previous,action,verified,args,parse,exec")
+    else:
+        print("%8s %12s %14s  %-20s %-8s %4s %12s %12s   (%s)" % ("seq", "start", "since previous", "action", "verified", "args", "parse", "exec", unit))
+
+    # Entries present in several dumps are printed once
+    last_seq = -1
+    prev_start = None
+
+    for total, entries in dumps:
+        for seq, start, parse, exe, name, verified, nargs in entries:
+            if seq <= last_seq:
+                continue
+
+            # Time stamps wrap at 32 bits
+            delta = "" if prev_start is None or seq != last_seq + 1 else conv((start - prev_start) & 0xFFFFFFFF)
+
+            if args.csv:
+                print("%u,%u,%s,%s,%u,%u,%s,%s" % (seq, start, delta, name, verified, nargs, conv(parse), conv(exe)))
+            else:
+                print("%8u %12u %14s  %-20s %-8s %4u %12s %12s" % (seq, start, delta if delta == "" else "%.6g" % delta, name,
+                                                                   "yes" if verified else "no", nargs,
+                                                                   "%.6g" % conv(parse), "%.6g" % conv(exe)))
+
+            last_seq = seq
+            prev_start = start
+
+
+if __name__ == "__main__":
+    main()
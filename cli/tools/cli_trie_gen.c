@@ -0,0 +1,188 @@
+/*
+ * cli_trie_gen.c
+ *
+ * Host tool that walks cliMainMenu and prints the C source of the prefix trie used when CLI_TRIE_EN is 1.
+ *
+ * Build it on the host with the same menu sources and configuration as the firmware, but with CLI_TRIE_EN left to 0 :
+ *
+ *     gcc -Icli/inc -DCLI_TRIE_EN=0 cli/tools/cli_trie_gen.c cli/src/cli_internal.c <menu sources> -o cli_trie_gen
+ *     ./cli_trie_gen > cli_trie.c
+ *
+ * Then compile cli_trie.c with the firmware and set CLI_TRIE_EN to 1. Sub menus are numbered in depth first order, starting
+ * with the main menu (index 0), which is the order cli_find_action walks them in.
+ */
+
+#include "cli.h"
+
+/**********************************************
+ * DEFINES
+ *********************************************/
+
+#define GEN_MAX_NODES       8192
+#define GEN_MAX_MENUS       1024
+#define GEN_MAX_ELEMENTS    1024
+#define GEN_MAX_DEPTH       32
+
+/**********************************************
+ * EXTERNAL VARIABLES
+ *********************************************/
+
+extern cliElement_t cliMainMenu[];
+
+/**********************************************
+ * PRIVATE VARIABLES
+ *********************************************/
+
+static cliTrieNode_t nodes[GEN_MAX_NODES];
+static size_t nodesCount = 0;
+
+static uint16_t menuRoot[GEN_MAX_MENUS];
+static char const* menuName[GEN_MAX_MENUS];
+static size_t menuCount = 0;
+
+/**********************************************
+ * PRIVATE FUNCTIONS
+ *********************************************/
+
+static bool gen_is_terminator(cliElement_t const * const e){
+    return (e->name == NULL && e->action == NULL && e->args == NULL && e->desc == NULL && e->argsDesc == NULL);
+}
+
+static uint16_t gen_new_node(char c, uint16_t element){
+    if(nodesCount >= GEN_MAX_NODES){
+        fprintf(stderr, "Too many trie nodes, increase GEN_MAX_NODES\n");
+        exit(1);
+    }
+
+    nodes[nodesCount].next = CLI_TRIE_NONE;
+    nodes[nodesCount].sibling = CLI_TRIE_NONE;
+    nodes[nodesCount].element = element;
+    nodes[nodesCount].c = c;
+
+    return (uint16_t) nodesCount++;
+}
+
+//Builds the node reached with prefix of size 'depth', shared by the 'count' elements listed in 'idx'
+static uint16_t gen_build_node(cliElement_t const menu[], uint16_t const idx[], size_t count, size_t depth, char c, uint16_t const subMenu[]){
+    if(count == 1){
+        uint16_t n = gen_new_node(c, idx[0]);
+        nodes[n].next = subMenu[idx[0]];
+        return n;
+    }
+
+    uint16_t n = gen_new_node(c, CLI_TRIE_AMBIGUOUS);
+    uint16_t last = CLI_TRIE_NONE;
+    bool done[GEN_MAX_ELEMENTS] = { 0 };
+
+    for(size_t i = 0; i < count; i++){
+        char const ci = (char) tolower(menu[idx[i]].name[depth]);
+
+        if(ci == '\0' || done[i]) continue;
+
+        uint16_t group[GEN_MAX_ELEMENTS];
+        size_t groupCount = 0;
+
+        for(size_t j = i; j < count; j++){
+            if(done[j] || tolower(menu[idx[j]].name[depth]) != ci) continue;
+
+            done[j] = true;
+            group[groupCount++] = idx[j];
+        }
+
+        uint16_t child = gen_build_node(menu, group, groupCount, depth + 1, ci, subMenu);
+
+        if(last == CLI_TRIE_NONE) nodes[n].next = child;
+        else nodes[last].sibling = child;
+
+        last = child;
+    }
+
+    return n;
+}
+
+static void gen_build_menu(cliElement_t const menu[], char const* name, size_t depth){
+    if(depth > GEN_MAX_DEPTH){
+        fprintf(stderr, "Menu tree deeper than %d, is a sub menu referencing itself ?\n", GEN_MAX_DEPTH);
+        exit(1);
+    }
+
+    if(menuCount >= GEN_MAX_MENUS){
+        fprintf(stderr, "Too many menus, increase GEN_MAX_MENUS\n");
+        exit(1);
+    }
+
+    size_t const m = menuCount++;
+    menuName[m] = ( (name == NULL) ? "NULL_NAME" : name );
+
+    uint16_t idx[GEN_MAX_ELEMENTS];
+    uint16_t subMenu[GEN_MAX_ELEMENTS];
+    size_t count = 0;
+    size_t i = 0;
+
+    //Sub menus are numbered (depth first) while walking, before the leaves pointing to them are built
+    for(i = 0; !gen_is_terminator(&menu[i]); i++){
+        if(i >= GEN_MAX_ELEMENTS){
+            fprintf(stderr, "Too many elements in one menu, increase GEN_MAX_ELEMENTS\n");
+            exit(1);
+        }
+
+        subMenu[i] = CLI_TRIE_NONE;
+
+        if(menu[i].subMenuRef != NULL){
+            subMenu[i] = (uint16_t) menuCount;
+            gen_build_menu(menu[i].subMenuRef, menu[i].name, depth + 1);
+        }
+
+        if(menu[i].name == NULL || menu[i].name[0] == '\0') continue;
+
+        idx[count++] = (uint16_t) i;
+    }
+
+    if(count == 0){
+        menuRoot[m] = gen_new_node('\0', CLI_TRIE_AMBIGUOUS);
+        return;
+    }
+
+    menuRoot[m] = gen_build_node(menu, idx, count, 0, '\0', subMenu);
+}
+
+static void gen_print_char(char c){
+    if(c == '\0')               printf("'\\0'");
+    else if(c == '\'' || c == '\\') printf("'\\%c'", c);
+    else if(isprint((unsigned char) c)) printf("'%c'", c);
+    else                        printf("'\\x%02X'", (unsigned char) c);
+}
+
+/**********************************************
+ * PUBLIC FUNCTIONS
+ *********************************************/
+
+int main(void){
+    gen_build_menu(cliMainMenu, "main", 0);
+
+    printf("/*\n * cli_trie.c\n *\n *  Generated by cli_trie_gen, do not edit. %u menus, %u nodes (%u bytes)\n */\n\n",
+           (unsigned) menuCount, (unsigned) nodesCount, (unsigned) (nodesCount * sizeof(cliTrieNode_t)));
+
+    printf("#include \"cli.h\"\n\n");
+    printf("#if (defined(CLI_EN) && CLI_EN == 1) && (defined(CLI_TRIE_EN) && CLI_TRIE_EN == 1)\n\n");
+
+    printf("const uint16_t cliTrieMenuCount = %u;\n\n", (unsigned) menuCount);
+
+    printf("const uint16_t cliTrieMenuRoot[] = {\n");
+    for(size_t m = 0; m < menuCount; m++){
+        printf("    %u,    //%s\n", (unsigned) menuRoot[m], menuName[m]);
+    }
+    printf("};\n\n");
+
+    printf("const cliTrieNode_t cliTrie[] = {\n");
+    for(size_t n = 0; n < nodesCount; n++){
+        printf("    /* %4u */ { 0x%04X, 0x%04X, 0x%04X, ", (unsigned) n, nodes[n].next, nodes[n].sibling, nodes[n].element);
+        gen_print_char(nodes[n].c);
+        printf(" },\n");
+    }
+    printf("};\n\n");
+
+    printf("#endif\n");
+
+    return 0;
+}